@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_DAGSHARDINGPOLICY_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_DAGSHARDINGPOLICY_H
+
+#include "ttmlir/Dialect/TTIR/Analysis/DFShardingPolicy.h"
+#include <queue>
+
+namespace mlir::tt::ttir {
+
+// Builds shard subgraphs instead of linear chains. Forks and joins do not end
+// a subgraph, ShardSolver resolves layouts across all edges in between its
+// ops. Subgraph grows in schedule order by ops connected to it while tensors
+// kept in L1, from their producer until their last user, fit into L1 next to
+// the executing op. Ops which can't be sharded are skipped. With L1 spilling
+// enabled only tensors the op uses have to fit, L1SpillAnalysis later moves
+// the others out of L1 where needed.
+//
+class DAGShardingPolicy : public DFShardingPolicy {
+public:
+  DAGShardingPolicy(
+      Operation *rootOp, std::vector<ShardChainConfig> &shardChainConfigs,
+      const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &legalLayouts,
+      llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>> &schedule,
+      unsigned usableL1CacheSize, LayoutSizeCache *layoutSizeCache,
+      OpCostModel *costModel, const TuningDatabase *tuningDatabase = nullptr,
+      bool l1SpillEnabled = false)
+      : DFShardingPolicy(rootOp, shardChainConfigs, legalLayouts, schedule,
+                         usableL1CacheSize, layoutSizeCache, costModel,
+                         tuningDatabase),
+        l1SpillEnabled(l1SpillEnabled) {}
+
+  void run() override;
+
+protected:
+  void pickOpLayouts(const ShardChainConfig &shardChainConfig,
+                     ShardSolver &shardSolver) override;
+
+private:
+  // Live tensors not used by an op can be spilled to DRAM around it, see
+  // L1SpillAnalysis.
+  //
+  bool l1SpillEnabled = false;
+
+  llvm::SmallVector<Operation *> scheduleFunc(func::FuncOp func);
+  uint64_t getOutputL1Usage(Operation *op, LayoutAttr layout);
+  uint64_t getLiveL1Usage(Operation *op);
+  void resetLiveL1Usage();
+
+  // Position of each op in the schedule and position of its last user.
+  //
+  llvm::DenseMap<Operation *, int64_t> schedulePos;
+  llvm::DenseMap<Operation *, int64_t> lastUsePos;
+
+  // Ops whose output is used outside of the schedule, by func.return.
+  //
+  llvm::DenseSet<Operation *> usedOutsideOps;
+
+  // Ops with L1 sharded output per func, in schedule order, and their L1
+  // usage. Estimated while building subgraphs, exact once layout is picked.
+  //
+  llvm::DenseMap<Operation *, llvm::SmallVector<Operation *>> l1ResidentOps;
+  llvm::DenseMap<Operation *, uint64_t> l1Usage;
+
+  // Sharded tensors live at the last getLiveL1Usage query: func and position
+  // of the query, next L1 resident op to enter the live set, live ops with
+  // their L1 usage ordered by last use, and L1 usage of all live ops and of
+  // those used outside of the schedule.
+  //
+  Operation *liveFunc = nullptr;
+  int64_t livePos = 0;
+  size_t nextL1ResidentOp = 0;
+  llvm::DenseMap<Operation *, uint64_t> liveL1Ops;
+  std::priority_queue<std::pair<int64_t, Operation *>,
+                      std::vector<std::pair<int64_t, Operation *>>,
+                      std::greater<std::pair<int64_t, Operation *>>>
+      liveL1Expiry;
+  uint64_t liveL1Usage = 0;
+  uint64_t liveUsedOutsideL1Usage = 0;
+};
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_DAGSHARDINGPOLICY_H
@@ -6,7 +6,10 @@
 #define TTMLIR_DIALECT_TTIR_ANALYSIS_DFSHARDINGPOLICY_H
 
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
+#include "ttmlir/Dialect/TTIR/Analysis/OpCostModel.h"
 #include "ttmlir/Dialect/TTIR/Analysis/ShardChainConfig.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TuningDatabase.h"
 
 namespace mlir::tt::ttir {
 
@@ -14,24 +17,65 @@ namespace mlir::tt::ttir {
 // Schedule is also produced as a side effect of sharding.
 //
 class DFShardingPolicy {
-private:
+protected:
   Operation *rootOp;
   std::vector<ShardChainConfig> *shardChainConfigs;
   llvm::DenseMap<Operation *, std::vector<LayoutAttr>> legalLayouts;
   llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>> *schedule;
   unsigned usableL1CacheSize = 0;
+  LayoutSizeCache *layoutSizeCache = nullptr;
+  OpCostModel *costModel = nullptr;
+  const TuningDatabase *tuningDatabase = nullptr;
+
+  double getIncomingReshardCost(
+      Operation *op, LayoutAttr layout, const ShardSolver &shardSolver,
+      const llvm::DenseMap<Operation *, LayoutAttr> &selectedOpLayout,
+      Operation *skipProducerOp = nullptr);
+
+  // Picks layout for every op in the resolved shard chain and commits it to
+  // the solver. Greedy op by op in chain order.
+  //
+  virtual void pickOpLayouts(const ShardChainConfig &shardChainConfig,
+                             ShardSolver &shardSolver);
+
+  // Resolves all built shard chain configs and picks their layouts.
+  //
+  void resolveShardChains();
+
+  // Layout tuned for the op by an earlier compilation if it is still valid
+  // for the op, null otherwise.
+  //
+  LayoutAttr getTunedLayout(Operation *op,
+                            const ShardSolver &shardSolver) const;
+
+private:
+  bool isValidChainSplitFactor(const ShardChainConfig &shardChainConfig,
+                               Operation *currentOp, Operation *nextOp,
+                               unsigned splitFactor) const;
+  uint64_t getSplitOutputL1Usage(Operation *op, LayoutAttr layout,
+                                 unsigned splitFactor) const;
+  bool fitsInL1(Operation *currentOp, LayoutAttr currentOpLayout,
+                Operation *nextOp, LayoutAttr nextOpLayout, bool isChainStart,
+                unsigned splitFactor) const;
+
+  LayoutAttr
+  pickOpLayout(Operation *op, const ShardSolver &shardSolver,
+               const llvm::DenseMap<Operation *, LayoutAttr> &selectedOpLayout);
 
 public:
   DFShardingPolicy(
       Operation *rootOp, std::vector<ShardChainConfig> &shardChainConfigs,
       const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &legalLayouts,
       llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>> &schedule,
-      unsigned usableL1CacheSize)
+      unsigned usableL1CacheSize, LayoutSizeCache *layoutSizeCache,
+      OpCostModel *costModel, const TuningDatabase *tuningDatabase = nullptr)
       : rootOp(rootOp), shardChainConfigs(&shardChainConfigs),
         legalLayouts(legalLayouts), schedule(&schedule),
-        usableL1CacheSize(usableL1CacheSize) {}
+        usableL1CacheSize(usableL1CacheSize), layoutSizeCache(layoutSizeCache),
+        costModel(costModel), tuningDatabase(tuningDatabase) {}
+  virtual ~DFShardingPolicy() = default;
 
-  void run();
+  virtual void run();
 };
 
 } // namespace mlir::tt::ttir
@@ -0,0 +1,36 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_DPSHARDINGPOLICY_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_DPSHARDINGPOLICY_H
+
+#include "ttmlir/Dialect/TTIR/Analysis/DFShardingPolicy.h"
+
+namespace mlir::tt::ttir {
+
+// Builds shard chains same as DFShardingPolicy, but picks layouts for a whole
+// chain at once. Runs Viterbi style dynamic programming over layouts left by
+// ShardSolver and minimizes sum of op costs and reshard costs along the chain.
+//
+class DPShardingPolicy : public DFShardingPolicy {
+public:
+  using DFShardingPolicy::DFShardingPolicy;
+
+protected:
+  void pickOpLayouts(const ShardChainConfig &shardChainConfig,
+                     ShardSolver &shardSolver) override;
+
+private:
+  // Picks the cheapest layout of every chain op into selectedLayouts. With
+  // tunedOnly, the tuned layout is the only candidate of an op having one.
+  // Returns false if no assignment of candidates is valid on chain edges.
+  //
+  bool pickChainLayouts(const ShardChainConfig &shardChainConfig,
+                        const ShardSolver &shardSolver, bool tunedOnly,
+                        llvm::SmallVector<LayoutAttr> &selectedLayouts);
+};
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_DPSHARDINGPOLICY_H
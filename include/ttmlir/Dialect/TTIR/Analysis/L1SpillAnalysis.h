@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_L1SPILLANALYSIS_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_L1SPILLANALYSIS_H
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TTIRAnalysis.h"
+#include "llvm/ADT/DenseSet.h"
+
+namespace mlir::tt::ttir {
+
+// Output of op is moved to DRAM after spillAfterOp and moved back to its L1
+// layout before refillBeforeOp, its next user. Spills of the same op are in
+// schedule order, later ones spill the refilled tensor.
+//
+struct L1Spill {
+  Operation *op;
+  Operation *spillAfterOp;
+  Operation *refillBeforeOp;
+};
+
+struct L1SpillAnalysisInput {
+  llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>> schedule;
+  llvm::DenseMap<Operation *, LayoutAttr> opLayouts;
+  unsigned usableL1CacheSize = 0;
+  LayoutSizeCache *layoutSizeCache = nullptr;
+
+  // Ops whose output and operands are never spilled, e.g. ops of streamed
+  // shard chains which are rewritten slice by slice.
+  //
+  llvm::DenseSet<Operation *> fixedOps;
+
+  L1SpillAnalysisInput() : schedule(), opLayouts(), fixedOps() {}
+
+  L1SpillAnalysisInput(
+      const llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>>
+          &schedule,
+      const llvm::DenseMap<Operation *, LayoutAttr> &opLayouts,
+      unsigned usableL1CacheSize, LayoutSizeCache *layoutSizeCache,
+      const llvm::DenseSet<Operation *> &fixedOps)
+      : schedule(schedule), opLayouts(opLayouts),
+        usableL1CacheSize(usableL1CacheSize), layoutSizeCache(layoutSizeCache),
+        fixedOps(fixedOps) {}
+
+  bool operator==(const L1SpillAnalysisInput &rhs) const {
+    return schedule == rhs.schedule && opLayouts == rhs.opLayouts &&
+           usableL1CacheSize == rhs.usableL1CacheSize &&
+           layoutSizeCache == rhs.layoutSizeCache && fixedOps == rhs.fixedOps;
+  }
+
+  bool operator!=(const L1SpillAnalysisInput &rhs) const {
+    return !(*this == rhs);
+  }
+};
+
+struct L1SpillAnalysisResult {
+  std::vector<L1Spill> spills;
+
+  // Ops at whose step live L1 stays over usable L1 even with spills, because
+  // everything live there is used by the op or can't be spilled. Schedule
+  // order.
+  //
+  llvm::SmallVector<Operation *> overSubscribedOps;
+
+  L1SpillAnalysisResult() : spills(), overSubscribedOps() {}
+};
+
+// Plans DRAM spills of sharded L1 tensors so that live L1 of every step of
+// the schedule, including execution of the op, fits into usable L1. Walks the
+// schedule and at every over-subscribed step evicts live tensors which the
+// op doesn't use, furthest next use times size first. Evicted tensor leaves
+// L1 right after its last user before the step and comes back right before
+// its next user. Tensors used outside of the schedule are never evicted.
+// Funcs without schedule are taken in program order.
+//
+class L1SpillAnalysis
+    : public TTIRAnalysis<L1SpillAnalysisInput, L1SpillAnalysisResult> {
+
+private:
+  void analysisImplementation() override;
+  bool applyOverrides() override;
+
+  void planFunc(ArrayRef<Operation *> schedule);
+
+public:
+  L1SpillAnalysis(Operation *op) : TTIRAnalysis(op) {}
+};
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_L1SPILLANALYSIS_H
@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_L1USAGE_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_L1USAGE_H
+
+#include "mlir/IR/Operation.h"
+#include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+
+namespace mlir::tt::ttir {
+
+// L1 bytes per core an op needs while executing with output in given layout,
+// on top of its input and output tensors: circular buffers, scratch space and
+// program. Zero for non TTIR ops.
+//
+uint64_t getOpL1ExecUsage(Operation *op, LayoutAttr outputLayout);
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_L1USAGE_H
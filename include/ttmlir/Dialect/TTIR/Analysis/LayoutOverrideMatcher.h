@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_LAYOUTOVERRIDEMATCHER_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_LAYOUTOVERRIDEMATCHER_H
+
+#include "mlir/IR/Operation.h"
+#include "ttmlir/Dialect/TT/Utils/OverrideParams.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/GlobPattern.h"
+#include <optional>
+#include <vector>
+
+namespace mlir::tt::ttir {
+
+// Matches ops to output layout overrides. Key of an override is one of:
+//
+// * op loc name, matched exactly, e.g. "add_1_0"
+// * glob over op loc name, e.g. "*attention.softmax*"
+// * "@" followed by op type, optionally followed by output shape with "*" for
+//   any dim size, e.g. "@ttir.softmax" or "@ttir.matmul<*x1024>"
+//
+// Keys are compiled once, so that lookup stays cheap on models with many ops.
+// If several keys match an op, exact name wins, then op type with shape, then
+// op type, then glob. Among several matching op type keys with shape or
+// several matching globs the lexicographically smallest key wins.
+//
+class LayoutOverrideMatcher {
+public:
+  LayoutOverrideMatcher() = default;
+
+  // Compiles keys of overrides. Fails on the first key which is not valid.
+  //
+  static llvm::Expected<LayoutOverrideMatcher>
+  create(const llvm::StringMap<LayoutOverrideParams> &overrides);
+
+  // Fails if key is not a valid override key.
+  //
+  static llvm::Error verifyKey(StringRef key);
+
+  // Returns override of the op, or nullptr if no key matches it.
+  //
+  const LayoutOverrideParams *lookup(Operation *op) const;
+
+  bool empty() const {
+    return nameOverrides.empty() && opTypeOverrides.empty() &&
+           globOverrides.empty();
+  }
+
+private:
+  struct OpTypeOverride {
+    // Dim sizes of output, ShapedType::kDynamic matches any size.
+    //
+    std::optional<llvm::SmallVector<int64_t>> shape;
+    const LayoutOverrideParams *params;
+  };
+
+  struct GlobOverride {
+    llvm::GlobPattern pattern;
+    const LayoutOverrideParams *params;
+  };
+
+  static bool isGlob(StringRef key);
+  static llvm::Expected<OpTypeOverride>
+  parseOpTypeKey(StringRef key, StringRef &opType);
+
+  llvm::StringMap<const LayoutOverrideParams *> nameOverrides;
+  llvm::StringMap<llvm::SmallVector<OpTypeOverride, 1>> opTypeOverrides;
+  std::vector<GlobOverride> globOverrides;
+};
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_LAYOUTOVERRIDEMATCHER_H
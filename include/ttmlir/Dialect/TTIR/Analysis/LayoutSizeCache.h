@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_LAYOUTSIZECACHE_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_LAYOUTSIZECACHE_H
+
+#include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+#include "llvm/ADT/SmallVector.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace mlir::tt::ttir {
+
+// Key of a single DeviceAttr::getLayoutSizeBytes query. Attributes are
+// uniqued, so they are compared by pointer.
+//
+struct LayoutSizeKey {
+  DeviceAttr device;
+  LayoutAttr layout;
+  MemorySpace memorySpace;
+  llvm::SmallVector<int64_t, 4> tensorShape;
+
+  LayoutSizeKey(DeviceAttr device, LayoutAttr layout, MemorySpace memorySpace,
+                ArrayRef<int64_t> tensorShape)
+      : device(device), layout(layout), memorySpace(memorySpace),
+        tensorShape(tensorShape.begin(), tensorShape.end()) {}
+
+  bool operator==(const LayoutSizeKey &other) const {
+    return device == other.device && layout == other.layout &&
+           memorySpace == other.memorySpace &&
+           tensorShape == other.tensorShape;
+  }
+};
+
+} // namespace mlir::tt::ttir
+
+namespace std {
+template <> struct hash<mlir::tt::ttir::LayoutSizeKey> {
+  size_t operator()(const mlir::tt::ttir::LayoutSizeKey &key) const noexcept {
+    llvm::hash_code code = llvm::hash_combine(
+        key.device.getAsOpaquePointer(), key.layout.getAsOpaquePointer(),
+        static_cast<uint32_t>(key.memorySpace));
+    code = llvm::hash_combine(code,
+                              llvm::hash_combine_range(key.tensorShape.begin(),
+                                                       key.tensorShape.end()));
+    return code;
+  }
+};
+} // namespace std
+
+namespace mlir::tt::ttir {
+
+// Optimizer-wide memoization of tensor footprints. Same (shape, layout, memory
+// space) queries are issued many times by legal grid analysis, sharding policy
+// and shard solver, and each one composes affine maps on the device.
+//
+// Safe to use from multiple threads.
+//
+class LayoutSizeCache {
+public:
+  uint64_t getLayoutSizeBytes(DeviceAttr device, ArrayRef<int64_t> tensorShape,
+                              LayoutAttr layout, MemorySpace memorySpace);
+
+  uint64_t getNumHits() const;
+  uint64_t getNumMisses() const;
+
+private:
+  mutable std::mutex mutex;
+  std::unordered_map<LayoutSizeKey, uint64_t> cache;
+  uint64_t numHits = 0;
+  uint64_t numMisses = 0;
+};
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_LAYOUTSIZECACHE_H
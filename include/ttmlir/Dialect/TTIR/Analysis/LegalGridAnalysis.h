@@ -6,9 +6,11 @@
 #define TTMLIR_DIALECT_TTIR_ANALYSIS_LEGALGRIDANALYSIS_H
 
 #include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
-#include "ttmlir/Dialect/TT/Utils/OverrideParams.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutOverrideMatcher.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LegalLayoutCache.h"
+#include "ttmlir/Dialect/TTIR/Analysis/OpCostModel.h"
 #include "ttmlir/Dialect/TTIR/Analysis/TTIRAnalysis.h"
-#include "llvm/ADT/StringMap.h"
 
 namespace mlir::tt::ttir {
 
@@ -17,22 +19,34 @@ struct LegalGridAnalysisInput {
   GridAttr maxGrid;
   RankedTensorType tensorType;
   int64_t maxShardedGrids = 64;
-  llvm::StringMap<LayoutOverrideParams> *outputLayoutOverrides;
+  const LayoutOverrideMatcher *outputLayoutOverrides;
+  LayoutSizeCache *layoutSizeCache;
+  LegalLayoutCache *legalLayoutCache;
+  OpCostModel *costModel;
 
   LegalGridAnalysisInput()
       : chipDesc(nullptr), maxGrid(nullptr), tensorType(nullptr),
-        outputLayoutOverrides(nullptr) {}
+        outputLayoutOverrides(nullptr), layoutSizeCache(nullptr),
+        legalLayoutCache(nullptr), costModel(nullptr) {}
 
   LegalGridAnalysisInput(
       ChipDescAttr chipDesc, GridAttr maxGrid, RankedTensorType tensorType,
-      llvm::StringMap<LayoutOverrideParams> *outputLayoutOverrides)
+      const LayoutOverrideMatcher *outputLayoutOverrides,
+      LayoutSizeCache *layoutSizeCache,
+      LegalLayoutCache *legalLayoutCache = nullptr,
+      OpCostModel *costModel = nullptr)
       : chipDesc(chipDesc), maxGrid(maxGrid), tensorType(tensorType),
-        outputLayoutOverrides(outputLayoutOverrides) {}
+        outputLayoutOverrides(outputLayoutOverrides),
+        layoutSizeCache(layoutSizeCache), legalLayoutCache(legalLayoutCache),
+        costModel(costModel) {}
 
   bool operator==(const LegalGridAnalysisInput &rhs) const {
     return chipDesc == rhs.chipDesc && maxGrid == rhs.maxGrid &&
            tensorType == rhs.tensorType &&
-           outputLayoutOverrides == rhs.outputLayoutOverrides;
+           outputLayoutOverrides == rhs.outputLayoutOverrides &&
+           layoutSizeCache == rhs.layoutSizeCache &&
+           legalLayoutCache == rhs.legalLayoutCache &&
+           costModel == rhs.costModel;
   }
 
   bool operator!=(const LegalGridAnalysisInput &rhs) const {
@@ -45,6 +59,7 @@ class LegalGridAnalysis
 private:
   void analysisImplementation() override;
   bool applyOverrides() override;
+  void generateLegalLayouts();
 
 public:
   LegalGridAnalysis(Operation *op) : TTIRAnalysis(op) {}
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_LEGALLAYOUTCACHE_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_LEGALLAYOUTCACHE_H
+
+#include "mlir/IR/OperationSupport.h"
+#include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+#include "llvm/ADT/SmallString.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace mlir::tt::ttir {
+
+// Structural signature of an op as seen by legal grid analysis. Legal layouts
+// depend only on op name, output tensor type (shape, element type and current
+// layout) and grid limits. Types and attributes are uniqued, so they are
+// compared by pointer.
+//
+struct LegalLayoutKey {
+  OperationName opName;
+  RankedTensorType tensorType;
+  GridAttr maxGrid;
+  int64_t maxShardedGrids;
+
+  LegalLayoutKey(OperationName opName, RankedTensorType tensorType,
+                 GridAttr maxGrid, int64_t maxShardedGrids)
+      : opName(opName), tensorType(tensorType), maxGrid(maxGrid),
+        maxShardedGrids(maxShardedGrids) {}
+
+  bool operator==(const LegalLayoutKey &other) const {
+    return opName == other.opName && tensorType == other.tensorType &&
+           maxGrid == other.maxGrid &&
+           maxShardedGrids == other.maxShardedGrids;
+  }
+};
+
+} // namespace mlir::tt::ttir
+
+namespace std {
+template <> struct hash<mlir::tt::ttir::LegalLayoutKey> {
+  size_t operator()(const mlir::tt::ttir::LegalLayoutKey &key) const noexcept {
+    return llvm::hash_combine(key.opName.getAsOpaquePointer(),
+                              key.tensorType.getAsOpaquePointer(),
+                              key.maxGrid.getAsOpaquePointer(),
+                              key.maxShardedGrids);
+  }
+};
+} // namespace std
+
+namespace mlir::tt::ttir {
+
+// Legal layouts shared by all structurally identical ops, e.g. ops of
+// repeated transformer layers. Entries are only valid for one system desc and
+// device, identified by fingerprint. Cache can be saved to a file and loaded
+// by later compilations with the same fingerprint.
+//
+// Safe to use from multiple threads.
+//
+class LegalLayoutCache {
+public:
+  LegalLayoutCache(StringRef fingerprint) : fingerprint(fingerprint) {}
+
+  // Version of legal layout generation and of the file format. Bump whenever
+  // LegalGridAnalysis generates different layouts for the same key, so files
+  // saved by older compilers are not loaded.
+  //
+  static constexpr uint32_t kVersion = 1;
+
+  // Fingerprint of the system desc and device legal layouts are generated
+  // for, and of kVersion.
+  //
+  static llvm::SmallString<32> getFingerprint(SystemDescAttr systemDesc,
+                                              DeviceAttr device);
+
+  // Returns cached legal layouts or nullptr. Returned entry stays valid for
+  // the lifetime of the cache.
+  //
+  const std::vector<LayoutAttr> *lookup(const LegalLayoutKey &key);
+
+  // Adds legal layouts for key. Existing entry is kept, as legal layouts of
+  // the same key are always the same.
+  //
+  void insert(const LegalLayoutKey &key,
+              const std::vector<LayoutAttr> &legalLayouts);
+
+  // Loads entries from file. Fails if file can't be read or parsed, no entry
+  // is added then. File with different fingerprint is skipped without error.
+  //
+  LogicalResult load(MLIRContext *context, StringRef path);
+
+  // Saves all entries to file, sorted so that the same entries always give
+  // the same file.
+  //
+  LogicalResult save(StringRef path) const;
+
+  uint64_t getNumHits() const;
+  uint64_t getNumMisses() const;
+
+private:
+  llvm::SmallString<32> fingerprint;
+  mutable std::mutex mutex;
+  std::unordered_map<LegalLayoutKey, std::vector<LayoutAttr>> cache;
+  uint64_t numHits = 0;
+  uint64_t numMisses = 0;
+};
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_LEGALLAYOUTCACHE_H
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_MEMORYSCHEDULEANALYSIS_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_MEMORYSCHEDULEANALYSIS_H
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TTIRAnalysis.h"
+
+namespace mlir::tt::ttir {
+
+// Per core bytes of live tensors in memory space at every step of a schedule,
+// including output of the op at that step. Tensor is live from its producer
+// until its last user in the schedule, or until the end if it is used outside
+// of the schedule. Op layout is taken from opLayouts, or from the output
+// tensor if op is not there.
+//
+std::vector<uint64_t>
+getScheduleMemoryUsage(ArrayRef<Operation *> schedule,
+                       const llvm::DenseMap<Operation *, LayoutAttr> &opLayouts,
+                       MemorySpace memorySpace,
+                       LayoutSizeCache *layoutSizeCache);
+
+// Peak of getScheduleMemoryUsage over the schedule.
+//
+uint64_t getSchedulePeakMemoryUsage(
+    ArrayRef<Operation *> schedule,
+    const llvm::DenseMap<Operation *, LayoutAttr> &opLayouts,
+    MemorySpace memorySpace, LayoutSizeCache *layoutSizeCache);
+
+// TTIR ops of the func scheduled in program order.
+//
+llvm::SmallVector<Operation *> getProgramOrderSchedule(func::FuncOp func);
+
+struct MemoryScheduleAnalysisInput {
+  llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>> schedule;
+  llvm::DenseMap<Operation *, LayoutAttr> opLayouts;
+  unsigned usableL1CacheSize = 0;
+  LayoutSizeCache *layoutSizeCache = nullptr;
+
+  MemoryScheduleAnalysisInput() : schedule(), opLayouts() {}
+
+  MemoryScheduleAnalysisInput(
+      const llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>>
+          &schedule,
+      const llvm::DenseMap<Operation *, LayoutAttr> &opLayouts,
+      unsigned usableL1CacheSize, LayoutSizeCache *layoutSizeCache)
+      : schedule(schedule), opLayouts(opLayouts),
+        usableL1CacheSize(usableL1CacheSize),
+        layoutSizeCache(layoutSizeCache) {}
+
+  bool operator==(const MemoryScheduleAnalysisInput &rhs) const {
+    return schedule == rhs.schedule && opLayouts == rhs.opLayouts &&
+           usableL1CacheSize == rhs.usableL1CacheSize &&
+           layoutSizeCache == rhs.layoutSizeCache;
+  }
+
+  bool operator!=(const MemoryScheduleAnalysisInput &rhs) const {
+    return !(*this == rhs);
+  }
+};
+
+struct MemoryScheduleAnalysisResult {
+  llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>> schedule;
+
+  // Peak L1 usage over all funcs, with input schedule and with result
+  // schedule.
+  //
+  uint64_t peakL1UsageBefore = 0;
+  uint64_t peakL1UsageAfter = 0;
+
+  MemoryScheduleAnalysisResult() : schedule() {}
+};
+
+// Reorders ops of every func to keep live L1 usage low. Greedy list
+// scheduler, among ready ops picks the one which grows live L1 the least,
+// and defers ops which would go over usable L1. Input schedule is kept if
+// the new one does not lower the peak. Funcs without input schedule start
+// from program order.
+//
+class MemoryScheduleAnalysis
+    : public TTIRAnalysis<MemoryScheduleAnalysisInput,
+                          MemoryScheduleAnalysisResult> {
+
+private:
+  void analysisImplementation() override;
+  bool applyOverrides() override;
+
+  llvm::SmallVector<Operation *> scheduleFunc(func::FuncOp func);
+
+public:
+  MemoryScheduleAnalysis(Operation *op) : TTIRAnalysis(op) {}
+};
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_MEMORYSCHEDULEANALYSIS_H
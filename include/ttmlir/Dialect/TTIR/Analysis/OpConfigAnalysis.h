@@ -6,25 +6,36 @@
 #define TTMLIR_DIALECT_TTIR_ANALYSIS_OPCONFIGANALYSIS_H
 
 #include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+#include "ttmlir/Dialect/TTIR/Analysis/OpCostModel.h"
 #include "ttmlir/Dialect/TTIR/Analysis/TTIRAnalysis.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TuningDatabase.h"
 
 namespace mlir::tt::ttir {
 
 struct OpConfigAnalysisInput {
   llvm::DenseMap<Operation *, std::vector<LayoutAttr>> legalGrids;
+  OpCostModel *costModel = nullptr;
+  const TuningDatabase *tuningDatabase = nullptr;
 
   OpConfigAnalysisInput() : legalGrids() {}
 
   OpConfigAnalysisInput(
-      const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &&legalGrids)
-      : legalGrids(std::move(legalGrids)) {}
+      const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &&legalGrids,
+      OpCostModel *costModel = nullptr,
+      const TuningDatabase *tuningDatabase = nullptr)
+      : legalGrids(std::move(legalGrids)), costModel(costModel),
+        tuningDatabase(tuningDatabase) {}
 
   OpConfigAnalysisInput(
-      const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &legalGrids)
-      : legalGrids(legalGrids) {}
+      const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &legalGrids,
+      OpCostModel *costModel = nullptr,
+      const TuningDatabase *tuningDatabase = nullptr)
+      : legalGrids(legalGrids), costModel(costModel),
+        tuningDatabase(tuningDatabase) {}
 
   bool operator==(const OpConfigAnalysisInput &rhs) const {
-    return legalGrids == rhs.legalGrids;
+    return legalGrids == rhs.legalGrids && costModel == rhs.costModel &&
+           tuningDatabase == rhs.tuningDatabase;
   }
 
   bool operator!=(const OpConfigAnalysisInput &rhs) const {
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_OPCOSTMODEL_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_OPCOSTMODEL_H
+
+#include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
+
+namespace mlir::tt::ttir {
+
+// Estimates latency of ops for candidate output layouts. Used by the optimizer
+// to pick the cheapest of the legal layouts. Costs are in device cycles and
+// only need to be comparable with each other.
+//
+class OpCostModel {
+public:
+  virtual ~OpCostModel() = default;
+
+  // Cost of executing op with its output in given layout.
+  //
+  virtual double getOpCost(Operation *op, LayoutAttr layout) = 0;
+
+  // Cost of converting tensor from srcLayout to dstLayout in between ops.
+  //
+  virtual double getReshardCost(RankedTensorType tensorType,
+                                LayoutAttr srcLayout, LayoutAttr dstLayout) = 0;
+};
+
+// Analytical cost model derived from chip description. Op cost is made of
+// dispatch overhead, which grows with the number of cores used, plus the
+// larger of compute (tiles per core) and data movement (L1 or DRAM bytes)
+// time.
+//
+class AnalyticalOpCostModel : public OpCostModel {
+public:
+  AnalyticalOpCostModel(ChipDescAttr chipDesc, DeviceAttr deviceAttr,
+                        LayoutSizeCache *layoutSizeCache)
+      : chipDesc(chipDesc), deviceAttr(deviceAttr),
+        layoutSizeCache(layoutSizeCache) {}
+
+  double getOpCost(Operation *op, LayoutAttr layout) override;
+  double getReshardCost(RankedTensorType tensorType, LayoutAttr srcLayout,
+                        LayoutAttr dstLayout) override;
+
+private:
+  double getMemoryCycles(ArrayRef<int64_t> tensorShape, LayoutAttr layout);
+
+  ChipDescAttr chipDesc;
+  DeviceAttr deviceAttr;
+  LayoutSizeCache *layoutSizeCache;
+};
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_OPCOSTMODEL_H
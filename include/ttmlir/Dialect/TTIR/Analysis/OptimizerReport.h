@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_OPTIMIZERREPORT_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_OPTIMIZERREPORT_H
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+#include "ttmlir/Dialect/TTIR/Analysis/Edge.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
+#include "ttmlir/Dialect/TTIR/Analysis/ShardChainConfig.h"
+#include "llvm/Support/JSON.h"
+#include <unordered_set>
+
+namespace mlir::tt::ttir {
+
+// Decisions of the optimizer for all funcs of a module.
+//
+struct OptimizerReportInput {
+  llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>> schedule;
+  llvm::DenseMap<Operation *, size_t> numLegalLayouts;
+  std::vector<ShardChainConfig> shardChainConfigs;
+  std::unordered_set<Edge> reshardedEdges;
+  llvm::DenseMap<Operation *, LayoutAttr> opLayouts;
+};
+
+// Machine readable report of optimizer decisions. For every func it lists
+// ops in schedule order with their legal layout count before and after shard
+// solving, picked layout and L1 bytes per core, shard chains, reshard edges
+// with bytes they move and live L1 bytes per core at every schedule step.
+//
+// Ops are referred to by schedule step, objects are printed with sorted keys,
+// so reports of two compiler versions for the same model diff cleanly.
+//
+class OptimizerReport {
+public:
+  // Bumped on every incompatible change of the report format.
+  //
+  static constexpr uint32_t kFormatVersion = 1;
+
+  static llvm::json::Value build(ModuleOp module,
+                                 const OptimizerReportInput &input,
+                                 LayoutSizeCache *layoutSizeCache);
+
+  static LogicalResult write(const llvm::json::Value &report, StringRef path);
+};
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_OPTIMIZERREPORT_H
@@ -15,6 +15,11 @@ struct ShardSpec {
   Operation *op;
   uint tensorSplitFactor;
   LayoutAttr layout;
+
+  // Number of legal layouts of the op left by shard solver before a layout
+  // is picked.
+  //
+  size_t numSolvedLayouts = 0;
 };
 
 // Enum to track the state of the shard chain.
@@ -22,9 +27,10 @@ struct ShardSpec {
 // Built: Shard chain is built, but not resolved yet. ShardSolver can be run.
 // Resolved: Shard chain is resolved. Reshards are computed. We can pick legal
 // layouts for each op. Completed: Shard chain is completed. ShardSpecs are
-// resolved to a single layout.
+// resolved to a single layout. Failed: ShardSolver found no valid layouts,
+// ops of the chain are not sharded.
 //
-enum class ShardChainState { InBuild, Built, Resolved, Completed };
+enum class ShardChainState { InBuild, Built, Resolved, Completed, Failed };
 
 class ShardChainConfig {
 private:
@@ -38,7 +44,7 @@ public:
 
   ShardSolver resolve(
       const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &legalLayouts,
-      unsigned usableL1CacheSize);
+      unsigned usableL1CacheSize, LayoutSizeCache *layoutSizeCache);
   void build();
   void complete(const llvm::DenseMap<Operation *, LayoutAttr> &selectedOpLayout,
                 std::unordered_set<Edge> &reshardedEdges);
@@ -50,6 +56,18 @@ public:
     shardSpecs.push_back(std::move(spec));
   }
   const std::vector<ShardSpec> &getShardSpecs() const { return shardSpecs; }
+
+  // All ops of a chain are streamed in the same number of slices.
+  //
+  void setTensorSplitFactor(uint tensorSplitFactor) {
+    assert(state == ShardChainState::InBuild);
+    for (ShardSpec &shardSpec : shardSpecs) {
+      shardSpec.tensorSplitFactor = tensorSplitFactor;
+    }
+  }
+  uint getTensorSplitFactor() const {
+    return shardSpecs.empty() ? 1 : shardSpecs.front().tensorSplitFactor;
+  }
   ShardChainState getState() const { return state; }
   const std::unordered_set<Edge> &getReshardedEdges() const {
     return reshardedEdges;
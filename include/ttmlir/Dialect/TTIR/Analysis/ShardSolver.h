@@ -7,8 +7,9 @@
 
 #include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
 #include "ttmlir/Dialect/TTIR/Analysis/Edge.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
+#include "llvm/ADT/BitVector.h"
 #include <algorithm>
-#include <bitset>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -30,31 +31,21 @@ struct ShardSolverSolution {
 
 class ShardSolver {
 private:
-  static constexpr size_t kNumBitsetBits = 64;
-  using Bitset = std::bitset<kNumBitsetBits>;
-  static Bitset kBitsetAll;
-  static constexpr Bitset kBitsetNone = Bitset{};
+  // Word-packed, dynamically sized bitset. Each op gets a bitset sized to the
+  // number of its legal layouts, so there is no cap on the number of
+  // candidates the solver can consider.
+  //
+  using Bitset = llvm::BitVector;
 
 public:
   struct RemainingLayoutAttrs {
     class Iterator {
       std::uint64_t i = 0;
       std::vector<LayoutAttr> const *p = nullptr;
-      Bitset mask = 0;
+      Bitset const *mask = nullptr;
 
     private:
-      void nextValid() {
-        if (mask == Bitset{}) {
-          i = p->size();
-          return;
-        }
-
-        while (mask.any() and not mask[i]) {
-          ++i;
-        }
-
-        mask.reset(i);
-      }
+      void nextValid(int next) { i = next < 0 ? p->size() : next; }
 
     public:
       using iterator_category = std::input_iterator_tag;
@@ -63,20 +54,19 @@ public:
       using pointer = const LayoutAttr *;
       using reference = const LayoutAttr &;
 
-      Iterator(std::vector<LayoutAttr> const *p, const Bitset &mask,
-               std::uint64_t i = 0)
-          : i(i), p(p), mask(mask) {
-        nextValid();
+      Iterator(std::vector<LayoutAttr> const *p, Bitset const *mask, int i)
+          : p(p), mask(mask) {
+        nextValid(i);
       }
 
       Iterator &operator++() {
-        nextValid();
+        nextValid(mask->find_next(i));
         return *this;
       }
 
       Iterator operator++(int) {
         auto r = *this;
-        nextValid();
+        nextValid(mask->find_next(i));
         return r;
       }
 
@@ -90,27 +80,22 @@ public:
     RemainingLayoutAttrs(std::vector<LayoutAttr> const &p, const Bitset &mask)
         : p(&p), mask(mask) {}
 
-    Iterator begin() const { return Iterator(p, mask); }
-    Iterator end() const {
-      return Iterator(p, 0, std::min(kNumBitsetBits, p->size()));
-    }
+    Iterator begin() const { return Iterator(p, &mask, mask.find_first()); }
+    Iterator end() const { return Iterator(p, &mask, -1); }
     size_t size() const { return mask.count(); }
 
     std::vector<LayoutAttr> const *p = nullptr;
-    Bitset mask = 0;
+    Bitset mask;
   };
 
   ShardSolverSolution const finish();
 
 private:
-  static Bitset bitset(std::uint64_t bit) {
-    Bitset b;
-    b.set(bit);
-    return b;
-  }
   // is `a` a subset of `b`
+  // BitVector::test(b) checks whether `a` has any bit that is not set in `b`.
+  //
   static bool isSubset(const Bitset &a, const Bitset &b) {
-    return a == (a & b);
+    return not a.test(b);
   }
 
   using PathSetId = int;
@@ -147,51 +132,50 @@ private:
     llvm::DenseSet<Operation *> controlSet;
   };
 
-  struct Path {
-    std::uint16_t producerId = 0;
-    std::uint16_t consumerId = 0;
-
-    Path() = default;
-    Path(std::uint16_t producerId, std::uint16_t consumerId)
-        : producerId(producerId), consumerId(consumerId) {}
-  };
-
   class PathSet {
   public:
-    using Paths = llvm::SmallVector<Path, 16>;
+    // Compatibility matrix of the edge. Row producerId holds consumer layouts
+    // which can be paired with producer layout producerId.
+    //
+    using Paths = std::vector<Bitset>;
 
-    PathSet(BitsetId producerSetId, BitsetId consumerSetId,
-            Operation *producerOperation, Operation *consumerOperation,
+    PathSet(BitsetId producerSetId, BitsetId consumerSetId, const Edge &edge,
             Paths const &paths)
         : producerSetId(producerSetId), consumerSetId(consumerSetId),
-          producerOperation(producerOperation),
-          consumerOperation(consumerOperation), paths(paths) {}
+          edge(edge), paths(paths) {}
 
     bool empty(const std::vector<Bitset> &bitsets) const {
-      return paths.empty() or (bitsets[producerSetId] == 0) or
-             (bitsets[consumerSetId] == 0);
+      return bitsets[producerSetId].none() or bitsets[consumerSetId].none();
     }
 
-    bool update(std::vector<Bitset> &bitsets) {
-      Bitset validProducerSet = 0;
-      Bitset validConsumerSet = 0;
-      Bitset producer = bitsets[producerSetId];
-      Bitset consumer = bitsets[consumerSetId];
-
-      for (size_t i = 0; i < paths.size(); i++) {
-        Path const &path = paths[i];
-        if (consumer[path.consumerId] and producer[path.producerId]) {
-          validProducerSet.set(path.producerId);
-          validConsumerSet.set(path.consumerId);
-        } else {
-          paths[i] = paths.back();
-          paths.pop_back();
-          i--;
+    // Collects producer and consumer layouts which are part of at least one
+    // path with both ends still valid.
+    //
+    void getValidSets(const std::vector<Bitset> &bitsets,
+                      Bitset &validProducerSet,
+                      Bitset &validConsumerSet) const {
+      Bitset const &producer = bitsets[producerSetId];
+      Bitset const &consumer = bitsets[consumerSetId];
+      validProducerSet = Bitset(producer.size());
+      validConsumerSet = Bitset(consumer.size());
+
+      for (int producerId : producer.set_bits()) {
+        if (paths[producerId].anyCommon(consumer)) {
+          validProducerSet.set(producerId);
+          validConsumerSet |= paths[producerId];
         }
       }
 
-      bool isProducerSub = isSubset(producer, validProducerSet);
-      bool isConsumerSub = isSubset(consumer, validConsumerSet);
+      validConsumerSet &= consumer;
+    }
+
+    bool update(std::vector<Bitset> &bitsets) const {
+      Bitset validProducerSet;
+      Bitset validConsumerSet;
+      getValidSets(bitsets, validProducerSet, validConsumerSet);
+
+      bool isProducerSub = isSubset(bitsets[producerSetId], validProducerSet);
+      bool isConsumerSub = isSubset(bitsets[consumerSetId], validConsumerSet);
       bool unchanged = isProducerSub and isConsumerSub;
 
       if (!unchanged) {
@@ -202,92 +186,110 @@ private:
       return not unchanged;
     }
 
-    void
-    updateOperationProcessor(std::vector<Bitset> &bitsets,
-                             OperationPathsProcessor *operation_processor) {
-      Bitset validProducerSet = 0;
-      Bitset validConsumerSet = 0;
-      Bitset producer = bitsets[producerSetId];
-      Bitset consumer = bitsets[consumerSetId];
-      for (size_t i = 0; i < paths.size(); i++) {
-        Path const &path = paths[i];
-        if (consumer[path.consumerId] and producer[path.producerId]) {
-          validProducerSet.set(path.producerId);
-          validConsumerSet.set(path.consumerId);
-        } else {
-          paths[i] = paths.back();
-          paths.pop_back();
-          i--;
-        }
-      }
+    void updateOperationProcessor(
+        std::vector<Bitset> &bitsets,
+        OperationPathsProcessor *operation_processor) const {
+      Bitset validProducerSet;
+      Bitset validConsumerSet;
+      getValidSets(bitsets, validProducerSet, validConsumerSet);
 
-      if (!isSubset(producer, validProducerSet)) {
-        operation_processor->addOp(consumerOperation);
-        operation_processor->addOp(producerOperation);
+      if (!isSubset(bitsets[producerSetId], validProducerSet)) {
+        operation_processor->addOp(edge.consumerOp);
+        operation_processor->addOp(edge.producerOp);
         bitsets[producerSetId] &= validProducerSet;
       }
 
-      if (!isSubset(consumer, validConsumerSet)) {
-        operation_processor->addOp(producerOperation);
-        operation_processor->addOp(consumerOperation);
+      if (!isSubset(bitsets[consumerSetId], validConsumerSet)) {
+        operation_processor->addOp(edge.producerOp);
+        operation_processor->addOp(edge.consumerOp);
         bitsets[consumerSetId] &= validConsumerSet;
       }
     }
 
-    Operation *getProducerOp() const { return producerOperation; }
-    Operation *getConsumerOp() const { return consumerOperation; }
+    Operation *getProducerOp() const { return edge.producerOp; }
+    Operation *getConsumerOp() const { return edge.consumerOp; }
+    const Edge &getEdge() const { return edge; }
+    bool hasPath(size_t producerId, size_t consumerId) const {
+      return paths[producerId].test(consumerId);
+    }
+    BitsetId getProducerSetId() const { return producerSetId; }
+    BitsetId getConsumerSetId() const { return consumerSetId; }
+    void setPaths(Paths const &newPaths) { paths = newPaths; }
 
-  private:
   private:
     BitsetId producerSetId = -1;
     BitsetId consumerSetId = -1;
-    Operation *producerOperation = nullptr;
-    Operation *consumerOperation = nullptr;
+    Edge edge;
     Paths paths;
   };
 
+  // Bitsets modified while propagating a single update. Original values are
+  // saved on first modification so that an update which leaves some edge
+  // without valid paths can be rolled back instead of re-solving the chain.
+  // Path sets are immutable during propagation and need no saving.
+  //
+  using UpdateTrail = llvm::DenseMap<BitsetId, Bitset>;
+
   const std::vector<LayoutAttr> &getLegalLayouts(Operation *operation) const;
-  void reset();
 
   PathSet *getPathSetPt(const Edge &edge);
+  PathSetId getPathSetId(const PathSet *pathSet) const;
   SmallVector<PathSet *> getOperandPathSetsPts(Operation *operation);
   SmallVector<PathSet *> getUserPathSetsPts(Operation *operation);
 
-  void handleNoPathsLeftOnUpdate(bool invokedBySet);
-  void updateSolver(Operation *root, bool expand_root = true,
-                    bool invokedBySet = false);
+  void saveToTrail(const PathSet *pathSet);
+  void rollbackTrail();
+  bool handleNoPathsLeftOnUpdate(PathSetId pathSetId);
+  bool updatePathSet(PathSet *pathSet, bool &changed,
+                     PathSetId &failedPathSetId);
+  bool updateSolver(Operation *root, PathSetId &failedPathSetId,
+                    bool expand_root = true);
 
   Bitset *getBitset(Operation *op);
   Bitset const *getBitset(Operation *op) const;
-  Bitset *getOrInsertBitset(Operation *op, const Bitset &init);
+  Bitset *getOrInsertBitset(Operation *op);
 
   void resolve();
-  bool resolveStep();
+  PathSet::Paths buildPaths(const Edge &edge, Bitset &edgeProducerBitset,
+                            Bitset &edgeConsumerBitset) const;
   void insertReshard(const Edge &edge);
   void addOperandsAndUsers(Operation *op, std::vector<Operation *> &needsUpdate,
                            Operation *ignoreOp = nullptr);
 
-  void preprocessFirstOp();
+  bool preprocessFirstOp();
   bool checkShardCompatible(Operation *producerOp,
                             LayoutAttr const &producerLayout,
                             Operation *consumerOp,
                             LayoutAttr const &consumerLayout) const;
+  uint64_t getSplitOutputL1Usage(Operation *op, LayoutAttr layout) const;
 
 public:
   ShardSolver(
       const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &legalLayouts,
       const std::vector<ShardSpec> &shardSpecs,
       const llvm::DenseSet<Operation *> &shardedOps,
-      const unsigned usableL1CacheSize);
+      const unsigned usableL1CacheSize, LayoutSizeCache *layoutSizeCache);
+  // False if there is no valid layout for some op of the chain, e.g. when no
+  // layout of the first op fits into L1 next to its input. Layouts of a chain
+  // without solution can't be queried or set.
+  //
+  bool isResolved() const { return chainResolved; }
   RemainingLayoutAttrs at(Operation *operation) const;
   void set(Operation *operation, LayoutAttr const &layout);
+  bool isResharded(const Edge &edge) const {
+    return reshardedEdges.count(edge) > 0;
+  }
+  bool isValidLayoutPair(const Edge &edge, LayoutAttr const &producerLayout,
+                         LayoutAttr const &consumerLayout) const;
 
 private:
   const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> *legalLayouts;
   const std::vector<ShardSpec> *shardSpecs;
   const llvm::DenseSet<Operation *> *shardedOps;
   unsigned usableL1CacheSize;
+  LayoutSizeCache *layoutSizeCache;
   DeviceAttr deviceAttr;
+  unsigned tensorSplitFactor = 1;
 
   llvm::DenseMap<Operation *, std::vector<Edge>> operandOpEdges;
   llvm::DenseMap<Operation *, std::vector<Edge>> userOpEdges;
@@ -295,9 +297,11 @@ private:
   std::vector<Bitset> bitsets;
   std::unordered_map<Edge, PathSetId> pathSetIds;
   std::unordered_map<Operation *, BitsetId> bitsetIds;
+  UpdateTrail trail;
 
   llvm::DenseMap<Operation *, LayoutAttr> selectedOpLayout;
   std::unordered_set<Edge> reshardedEdges;
+  bool chainResolved = false;
 };
 
 } // namespace mlir::tt::ttir
@@ -7,28 +7,47 @@
 
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "ttmlir/Dialect/TTIR/Analysis/Edge.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
+#include "ttmlir/Dialect/TTIR/Analysis/OpCostModel.h"
 #include "ttmlir/Dialect/TTIR/Analysis/ShardChainConfig.h"
+#include "ttmlir/Dialect/TTIR/Analysis/ShardingPolicyType.h"
 #include "ttmlir/Dialect/TTIR/Analysis/TTIRAnalysis.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TensorSplit.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TuningDatabase.h"
 
 namespace mlir::tt::ttir {
 
-enum class ShardingPolicyType {
-  DFSharding,
-};
-
 struct ShardingAnalysisInput {
   llvm::DenseMap<Operation *, std::vector<LayoutAttr>> legalLayouts;
   unsigned usableL1CacheSize = 0;
+  LayoutSizeCache *layoutSizeCache = nullptr;
+  OpCostModel *costModel = nullptr;
+  ShardingPolicyType policy = ShardingPolicyType::DFSharding;
+  const TuningDatabase *tuningDatabase = nullptr;
+
+  // Only DAG sharding grows subgraphs past tensors live next to an op, chains
+  // of the other policies don't account for them.
+  //
+  bool l1SpillEnabled = false;
 
   ShardingAnalysisInput() : legalLayouts() {}
 
   ShardingAnalysisInput(
       const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &legalLayouts,
-      unsigned usableL1CacheSize)
-      : legalLayouts(legalLayouts), usableL1CacheSize(usableL1CacheSize) {}
+      unsigned usableL1CacheSize, LayoutSizeCache *layoutSizeCache,
+      OpCostModel *costModel, ShardingPolicyType policy,
+      const TuningDatabase *tuningDatabase = nullptr,
+      bool l1SpillEnabled = false)
+      : legalLayouts(legalLayouts), usableL1CacheSize(usableL1CacheSize),
+        layoutSizeCache(layoutSizeCache), costModel(costModel), policy(policy),
+        tuningDatabase(tuningDatabase), l1SpillEnabled(l1SpillEnabled) {}
 
   bool operator==(const ShardingAnalysisInput &rhs) const {
-    return legalLayouts == rhs.legalLayouts;
+    return legalLayouts == rhs.legalLayouts &&
+           layoutSizeCache == rhs.layoutSizeCache &&
+           costModel == rhs.costModel && policy == rhs.policy &&
+           tuningDatabase == rhs.tuningDatabase &&
+           l1SpillEnabled == rhs.l1SpillEnabled;
   }
 
   bool operator!=(const ShardingAnalysisInput &rhs) const {
@@ -40,8 +59,12 @@ struct ShardingAnalysisResult {
   llvm::DenseMap<Operation *, std::vector<LayoutAttr>> legalLayouts;
   std::unordered_set<Edge> reshardedEdges;
   llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>> schedule;
+  std::vector<TensorSplitChain> tensorSplitChains;
+  std::vector<ShardChainConfig> shardChainConfigs;
 
-  ShardingAnalysisResult() : legalLayouts(), reshardedEdges(), schedule() {}
+  ShardingAnalysisResult()
+      : legalLayouts(), reshardedEdges(), schedule(), tensorSplitChains(),
+        shardChainConfigs() {}
 
   ShardingAnalysisResult(
       const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &legalLayouts,
@@ -0,0 +1,22 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_SHARDINGPOLICYTYPE_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_SHARDINGPOLICYTYPE_H
+
+namespace mlir::tt::ttir {
+
+// DFSharding: Greedy, picks cheapest valid layout op by op.
+// DPSharding: Picks layouts minimizing total cost of every shard chain.
+// DAGSharding: Shards subgraphs with forks and joins, bounded by live L1.
+//
+enum class ShardingPolicyType {
+  DFSharding,
+  DPSharding,
+  DAGSharding,
+};
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_SHARDINGPOLICYTYPE_H
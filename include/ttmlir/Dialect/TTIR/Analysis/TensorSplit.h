@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_TENSORSPLIT_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_TENSORSPLIT_H
+
+#include "mlir/IR/Operation.h"
+#include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+#include "llvm/ADT/SmallVector.h"
+
+namespace mlir::tt::ttir {
+
+// Shard chain whose tensors don't fit in L1 can be streamed: its input is
+// split into slices along the outer (first) dim and the whole chain runs once
+// per slice, with only one slice of every intermediate tensor in L1.
+//
+
+// Largest number of slices a shard chain is split into.
+//
+constexpr unsigned kMaxTensorSplitFactor = 16;
+
+// Shard chain streamed in splitFactor slices, ops in chain order.
+//
+struct TensorSplitChain {
+  llvm::SmallVector<Operation *> ops;
+  unsigned splitFactor = 1;
+};
+
+// True if op can run slice by slice along the outer dim of its output.
+//
+bool canSplitAlongOuterDim(Operation *op);
+
+// True if operand is split together with the output of the op. Other operands
+// are used whole by every slice.
+//
+bool isSplitOperand(Operation *op, unsigned operandIndex);
+
+// True if tensor can be split into splitFactor equal slices along its outer
+// dim, with every slice made of whole tiles.
+//
+bool isValidSplitFactor(RankedTensorType tensorType, LayoutAttr layout,
+                        unsigned splitFactor);
+
+// Shape of one of splitFactor slices of the tensor.
+//
+llvm::SmallVector<int64_t> getSplitShape(ArrayRef<int64_t> tensorShape,
+                                         unsigned splitFactor);
+
+// Layout of one of splitFactor slices of a tensor in given layout, on the same
+// grid.
+//
+LayoutAttr getSplitLayout(MLIRContext *context, ArrayRef<int64_t> tensorShape,
+                          LayoutAttr layout, unsigned splitFactor);
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_TENSORSPLIT_H
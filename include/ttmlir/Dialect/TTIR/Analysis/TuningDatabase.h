@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_DIALECT_TTIR_ANALYSIS_TUNINGDATABASE_H
+#define TTMLIR_DIALECT_TTIR_ANALYSIS_TUNINGDATABASE_H
+
+#include "mlir/IR/Operation.h"
+#include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
+#include <optional>
+
+namespace mlir::tt::ttir {
+
+// Layout picked for an op signature by an earlier compilation, together with
+// latency of the op in that layout. Latency is either estimated by the cost
+// model or measured on device.
+//
+struct TuningRecord {
+  LayoutAttr layout;
+  double latency = 0;
+  bool measured = false;
+};
+
+// Persistent database of tuned op layouts, keyed by op signature. Records are
+// only valid for one system desc and device, identified by fingerprint.
+//
+// Database is stored as size prefixed flatbuffer (tuning_db.fbs). Layouts of
+// imported records are parsed and validated once on import.
+//
+class TuningDatabase {
+public:
+  // Bumped on every incompatible change of record semantics. Files with
+  // different version are skipped on import.
+  //
+  static constexpr uint32_t kFormatVersion = 1;
+
+  TuningDatabase(StringRef fingerprint) : fingerprint(fingerprint) {}
+
+  // Signature of an op as seen by the optimizer: op name, operand types and
+  // result types.
+  //
+  static std::string getOpSignature(Operation *op);
+
+  // Returns tuned record for the op if there is one.
+  //
+  std::optional<TuningRecord> lookup(Operation *op) const;
+
+  // Returns record for the op from the imported file only, ignoring records
+  // of this compilation.
+  //
+  std::optional<TuningRecord> lookupImported(Operation *op) const;
+
+  // Records layout picked for the op. Measured latency of the same layout is
+  // not overridden by an estimate.
+  //
+  void record(Operation *op, LayoutAttr layout, double latency,
+              bool measured = false);
+
+  // Reads records from database file. Fails if file can't be read or is not a
+  // valid database, earlier imported records are kept then. File with
+  // different fingerprint or format version is skipped without error. Records
+  // with a layout that doesn't parse anymore are skipped with a warning at
+  // loc.
+  //
+  LogicalResult import(Location loc, StringRef path);
+
+  // Writes imported and recorded records to file. Recorded records override
+  // imported ones with the same signature.
+  //
+  LogicalResult exportTo(StringRef path) const;
+
+  size_t size() const;
+
+private:
+  llvm::SmallString<32> fingerprint;
+  llvm::StringMap<TuningRecord> importedRecords;
+  llvm::StringMap<TuningRecord> recordedRecords;
+};
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_DIALECT_TTIR_ANALYSIS_TUNINGDATABASE_H
@@ -13,6 +13,16 @@ namespace tt {
 namespace ttir {
 namespace detail {
 mlir::LogicalResult verifyElementwiseOp(mlir::Operation *op);
+
+// Reader, writer and compute kernels of a typical op.
+constexpr uint64_t kDefaultOpL1ProgramUsage = 16 * 1024;
+
+// Double buffered single tile circular buffer per operand.
+uint64_t getDefaultOpL1ScratchUsage(mlir::Operation *op,
+                                    mlir::tt::LayoutAttr outputLayout);
+
+// Size of a single tile of the layout's element type.
+uint64_t getTileSizeBytes(mlir::tt::LayoutAttr layout);
 } // namespace detail
 } // namespace ttir
 } // namespace tt
@@ -7,6 +7,7 @@
 
 #include "mlir/Pass/Pass.h"
 #include "ttmlir/Dialect/TT/Utils/OverrideParams.h"
+#include "ttmlir/Dialect/TTIR/Analysis/ShardingPolicyType.h"
 #include "ttmlir/Dialect/TTIR/IR/TTIR.h"
 #include "ttmlir/Dialect/TTIR/IR/TTIROps.h"
 #include <memory>
@@ -14,6 +14,14 @@ struct TTIRToTTMetalBackendPipelineOptions
     : public PassPipelineOptions<TTIRToTTMetalBackendPipelineOptions> {
   ListOption<int64_t> meshShape{
       *this, "mesh-shape", llvm::cl::desc("Set the multi-device mesh shape.")};
+
+  // CSV file to write per core memory usage at every op to, after the
+  // memory plan is validated against chip capacities.
+  //
+  Option<std::string> memoryOccupancyCsv{
+      *this, "memory-occupancy-csv",
+      llvm::cl::desc("CSV file to write memory usage at every op to."),
+      llvm::cl::init("")};
 };
 
 void createTTIRToTTMetalBackendPipeline(
@@ -7,6 +7,8 @@
 
 #include "mlir/Pass/PassOptions.h"
 #include "ttmlir/Dialect/TT/Utils/OverrideParams.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutOverrideMatcher.h"
+#include "ttmlir/Dialect/TTIR/Analysis/ShardingPolicyType.h"
 
 namespace mlir::tt::ttnn {
 struct LayoutOverrideParser
@@ -40,6 +42,12 @@ public:
         return true;
       }
 
+      if (llvm::Error error = ttir::LayoutOverrideMatcher::verifyKey(
+              opOverrideParts[iOpName])) {
+        opt.error(llvm::toString(std::move(error)));
+        return true;
+      }
+
       SmallVector<StringRef, kMaxLayoutOverrideParams> layoutParamParts;
       // Split into layout parameters.
       opOverrideParts[iLayoutOverrideParams].split(layoutParamParts,
@@ -131,6 +139,9 @@ struct TTIRToTTNNBackendPipelineOptions
   //
   // op_name=grid_size:memory_space:tensor_memory_layout
   //
+  // * op_name: op loc name, glob over op loc names (e.g. *softmax*) or "@"
+  //   followed by op type and optional output shape with "*" for any dim size
+  //   (e.g. @ttir.matmul<*x1024>)
   // * grid_size=2x2
   // * memory_space: system, mmio, dram or l1
   // * tensor_memory_layout: none, interleaved, single_bank, height_sharded,
@@ -156,6 +167,76 @@ struct TTIRToTTNNBackendPipelineOptions
       llvm::cl::desc("Enable sharding pass to shard ops."),
       llvm::cl::init(false)};
 
+  // Policy used by sharding pass to build shard chains and pick their
+  // layouts.
+  //
+  Option<ttir::ShardingPolicyType> shardingPolicy{
+      *this, "sharding-policy",
+      llvm::cl::desc("Policy used to build shard chains and pick layouts."),
+      llvm::cl::init(ttir::ShardingPolicyType::DFSharding),
+      llvm::cl::values(clEnumValN(ttir::ShardingPolicyType::DFSharding, "df",
+                                  "Greedy, cheapest layout op by op"),
+                       clEnumValN(ttir::ShardingPolicyType::DPSharding, "dp",
+                                  "Cheapest layout assignment of the whole "
+                                  "chain"),
+                       clEnumValN(ttir::ShardingPolicyType::DAGSharding, "dag",
+                                  "Subgraphs across forks and joins within "
+                                  "L1"))};
+
+  // If this option is true, reorder ops to lower peak L1 usage.
+  //
+  Option<bool> memoryAwareScheduling{
+      *this, "memory-aware-scheduling",
+      llvm::cl::desc("Reorder ops to lower peak L1 usage."),
+      llvm::cl::init(false)};
+
+  // If this option is true, sharded tensors are spilled to DRAM and refilled
+  // before their next use instead of ending shard chains when L1 is
+  // over-subscribed.
+  //
+  Option<bool> l1SpillEnabled{
+      *this, "l1-spill-enabled",
+      llvm::cl::desc("Spill sharded tensors to DRAM when L1 is "
+                     "over-subscribed."),
+      llvm::cl::init(false)};
+
+  // File to load legal layouts from and save them to. Reused only by
+  // compilations for the same system desc.
+  //
+  Option<std::string> legalLayoutCacheFile{
+      *this, "legal-layout-cache-file",
+      llvm::cl::desc("File to cache legal layouts in across compilations."),
+      llvm::cl::init("")};
+
+  // Tuning database files to seed op layouts from and to record picked op
+  // layouts to. Database is used only by compilations for the same system
+  // desc.
+  //
+  Option<std::string> tuningDatabaseImport{
+      *this, "tuning-db-import",
+      llvm::cl::desc("Tuning database file to seed op layouts from."),
+      llvm::cl::init("")};
+  Option<std::string> tuningDatabaseExport{
+      *this, "tuning-db-export",
+      llvm::cl::desc("Tuning database file to record picked op layouts to."),
+      llvm::cl::init("")};
+
+  // JSON file to write optimizer decisions to: shard chains, legal layout
+  // counts, picked layouts, reshards and L1 timeline of every func.
+  //
+  Option<std::string> optimizerReport{
+      *this, "optimizer-report",
+      llvm::cl::desc("JSON file to write optimizer decisions to."),
+      llvm::cl::init("")};
+
+  // CSV file to write per core memory usage at every op to, after the
+  // memory plan is validated against chip capacities.
+  //
+  Option<std::string> memoryOccupancyCsv{
+      *this, "memory-occupancy-csv",
+      llvm::cl::desc("CSV file to write memory usage at every op to."),
+      llvm::cl::init("")};
+
   // Option to provide a system descriptor flatbuffer file to compile
   // against.
   //
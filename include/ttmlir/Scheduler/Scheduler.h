@@ -5,7 +5,9 @@
 #ifndef TTMLIR_SCHEDULER_SCHEDULER_H
 #define TTMLIR_SCHEDULER_SCHEDULER_H
 
+#include <functional>
 #include <memory>
+#include <set>
 
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/Operation.h"
@@ -14,15 +16,31 @@ namespace mlir::tt::scheduler {
 
 class Scheduler {
 public:
+  // Priority of a schedulable operation, higher is scheduled first
+  using PriorityFn = std::function<int64_t(mlir::Operation *)>;
+
   // Constructor taking an MLIR Operation (or a module)
   Scheduler(func::FuncOp *root);
 
   // Copy constructor
   Scheduler(const Scheduler &scheduler);
 
-  // Method to get the next set of schedulable operations
+  // Method to get the next set of schedulable operations, in program order
   llvm::SmallVector<mlir::Operation *> getScheduleableOps();
 
+  // Method to get the schedulable operation with the highest priority, ties
+  // are broken by program order. Returns nullptr if none is schedulable.
+  // Priority may change as operations get scheduled, so it is evaluated for
+  // every schedulable operation on each call. Static priorities should use a
+  // method backed by a priority queue, like getNextCriticalPathOp
+  mlir::Operation *getNextScheduleableOp(const PriorityFn &priority) const;
+
+  // Method to get the schedulable operation on the longest path to the end
+  // of the graph, ties are broken by program order. Same as
+  // getNextScheduleableOp with criticalPathPriority, in logarithmic time.
+  // Returns nullptr if none is schedulable.
+  mlir::Operation *getNextCriticalPathOp() const;
+
   // Method to check if an operation can be scheduled
   bool canSchedule(mlir::Operation *op);
 
@@ -38,16 +56,45 @@ public:
   // Method to check if there are unscheduled operations
   bool hasUnscheduledOps() const;
 
+  // Method to get the number of operations on the longest path from the
+  // operation to the end of the graph, including the operation itself
+  int64_t getCriticalPathLength(mlir::Operation *op) const;
+
+  // Priority preferring operations on the longest path to the end of the
+  // graph
+  PriorityFn criticalPathPriority() const;
+
 private:
+  // Method to mark an operation with all dependencies scheduled as ready
+  void addReadyOp(mlir::Operation *op);
+
+  // Method to get the position of an operation of the func in program order
+  unsigned getOpIndex(mlir::Operation *op) const;
+
+  // Operations in program order
+  llvm::SmallVector<mlir::Operation *> ops;
+  // Position of each operation in program order
+  llvm::DenseMap<mlir::Operation *, unsigned> opIndex;
   // Map of scheduled operations
   llvm::DenseSet<mlir::Operation *> scheduledOpsMap;
   // Operation schedule in order of execution
   llvm::SmallVector<mlir::Operation *> schedule;
-  // Set of unscheduled operations
-  llvm::DenseSet<mlir::Operation *> unscheduledOps;
+  // Positions of unscheduled operations whose dependencies are all
+  // scheduled
+  std::set<unsigned> readyOps;
+  // Same operations ordered by descending critical path length, then by
+  // position
+  std::set<std::pair<int64_t, unsigned>> readyOpsByCriticalPath;
+  // Number of unscheduled dependencies of each operation
+  llvm::DenseMap<mlir::Operation *, unsigned> inDegree;
   // Map of dependencies
   llvm::DenseMap<mlir::Operation *, llvm::SmallVector<mlir::Operation *>>
       dependencies;
+  // Map of dependent operations, reverse of dependencies
+  llvm::DenseMap<mlir::Operation *, llvm::SmallVector<mlir::Operation *>>
+      dependents;
+  // Longest path to the end of the graph of each operation
+  llvm::DenseMap<mlir::Operation *, int64_t> criticalPathLength;
 };
 
 } // namespace mlir::tt::scheduler
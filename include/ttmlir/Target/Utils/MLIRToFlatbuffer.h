@@ -280,51 +280,70 @@ toFlatbuffer(FlatbufferObjectCache &cache, SystemDescAttr systemDesc) {
                                         chipChannels);
 }
 
+// Core range set of a tensor grid on the device worker grid, as a list of
+// rectangles. 1D grids of height and width sharded tensors may have more
+// cores than the worker grid has rows or columns, those are laid out over the
+// worker grid in row major order, so the last row of cores may be partial.
+//
 inline std::vector<::tt::target::Dim2dRange>
 toFlatbuffer(FlatbufferObjectCache &cache, GridAttr tensorGrid,
              GridAttr deviceGrid) {
   std::vector<::tt::target::Dim2dRange> coreRangeSet;
   SmallVector<std::int64_t> tensorGridShape(tensorGrid.getShape());
   AffineMap mapping = deviceGrid.getMapping();
-  ::ttmlir::utils::sample(
-      tensorGridShape, [&](ArrayRef<std::int64_t> virtualCoreCoord) {
-        SmallVector<std::int64_t> coreCoord = mapping.compose(virtualCoreCoord);
-        assert(coreCoord.size() == PhysGridResultIdx::NumIndices &&
-               "expected a 2D core");
-        assert(coreCoord[PhysGridResultIdx::DeviceIdx] == 0 &&
-               "expected single device");
-        if (!coreRangeSet.empty() &&
-            ((coreRangeSet.back().loc().y() ==
-              coreCoord[PhysGridResultIdx::CoreCoordY]) &&
-             (coreRangeSet.back().loc().x() + coreRangeSet.back().size().x()) ==
-                 coreCoord[PhysGridResultIdx::CoreCoordX])) {
-          coreRangeSet.back() = ::tt::target::Dim2dRange(
-              coreRangeSet.back().loc(),
-              ::tt::target::Dim2d(coreRangeSet.back().size().y(),
-                                  coreRangeSet.back().size().x() + 1));
-        } else {
-          coreRangeSet.push_back(::tt::target::Dim2dRange(
-              ::tt::target::Dim2d(coreCoord[PhysGridResultIdx::CoreCoordY],
-                                  coreCoord[PhysGridResultIdx::CoreCoordX]),
-              ::tt::target::Dim2d(1, 1)));
-        }
-        if (coreRangeSet.size() > 1 &&
-            (coreRangeSet[coreRangeSet.size() - 2].loc().x() ==
-             coreRangeSet.back().loc().x()) &&
-            (coreRangeSet[coreRangeSet.size() - 2].size().x() ==
-             coreRangeSet.back().size().x()) &&
-            ((coreRangeSet[coreRangeSet.size() - 2].loc().y() +
-              coreRangeSet[coreRangeSet.size() - 2].size().y()) ==
-             coreRangeSet.back().loc().y())) {
-          assert(coreRangeSet.back().size().y() == 1);
-          coreRangeSet[coreRangeSet.size() - 2] = ::tt::target::Dim2dRange(
-              coreRangeSet[coreRangeSet.size() - 2].loc(),
-              ::tt::target::Dim2d(
-                  coreRangeSet[coreRangeSet.size() - 2].size().y() + 1,
-                  coreRangeSet[coreRangeSet.size() - 2].size().x()));
-          coreRangeSet.pop_back();
-        }
-      });
+  auto addCore = [&](ArrayRef<std::int64_t> virtualCoreCoord) {
+    SmallVector<std::int64_t> coreCoord = mapping.compose(virtualCoreCoord);
+    assert(coreCoord.size() == PhysGridResultIdx::NumIndices &&
+           "expected a 2D core");
+    assert(coreCoord[PhysGridResultIdx::DeviceIdx] == 0 &&
+           "expected single device");
+    if (!coreRangeSet.empty() &&
+        ((coreRangeSet.back().loc().y() ==
+          coreCoord[PhysGridResultIdx::CoreCoordY]) &&
+         (coreRangeSet.back().loc().x() + coreRangeSet.back().size().x()) ==
+             coreCoord[PhysGridResultIdx::CoreCoordX])) {
+      coreRangeSet.back() = ::tt::target::Dim2dRange(
+          coreRangeSet.back().loc(),
+          ::tt::target::Dim2d(coreRangeSet.back().size().y(),
+                              coreRangeSet.back().size().x() + 1));
+    } else {
+      coreRangeSet.push_back(::tt::target::Dim2dRange(
+          ::tt::target::Dim2d(coreCoord[PhysGridResultIdx::CoreCoordY],
+                              coreCoord[PhysGridResultIdx::CoreCoordX]),
+          ::tt::target::Dim2d(1, 1)));
+    }
+    if (coreRangeSet.size() > 1 &&
+        (coreRangeSet[coreRangeSet.size() - 2].loc().x() ==
+         coreRangeSet.back().loc().x()) &&
+        (coreRangeSet[coreRangeSet.size() - 2].size().x() ==
+         coreRangeSet.back().size().x()) &&
+        ((coreRangeSet[coreRangeSet.size() - 2].loc().y() +
+          coreRangeSet[coreRangeSet.size() - 2].size().y()) ==
+         coreRangeSet.back().loc().y())) {
+      assert(coreRangeSet.back().size().y() == 1);
+      coreRangeSet[coreRangeSet.size() - 2] = ::tt::target::Dim2dRange(
+          coreRangeSet[coreRangeSet.size() - 2].loc(),
+          ::tt::target::Dim2d(
+              coreRangeSet[coreRangeSet.size() - 2].size().y() + 1,
+              coreRangeSet[coreRangeSet.size() - 2].size().x()));
+      coreRangeSet.pop_back();
+    }
+  };
+
+  ArrayRef<std::int64_t> deviceGridShape = deviceGrid.getShape();
+  if (tensorGridShape.size() == 2 && deviceGridShape.size() == 2 &&
+      (tensorGridShape[0] > deviceGridShape[0] ||
+       tensorGridShape[1] > deviceGridShape[1])) {
+    std::int64_t numCores = tensorGridShape[0] * tensorGridShape[1];
+    assert(numCores <= deviceGridShape[0] * deviceGridShape[1] &&
+           "expected tensor grid to fit the worker grid");
+    for (std::int64_t core = 0; core < numCores; ++core) {
+      addCore({core / deviceGridShape[1], core % deviceGridShape[1]});
+    }
+    return coreRangeSet;
+  }
+
+  ::ttmlir::utils::sample(tensorGridShape, addCore);
   return coreRangeSet;
 }
 
@@ -657,16 +657,21 @@ public:
   void convertInitUnaryOp(Operation &arithOrMathOp,
                           ArrayRef<BlockArgument> cbOperands,
                           OpBuilder &builder) const {
-    assert(cbOperands.size() == 2 &&
-           "Expected one input and one output CB for unary op.");
+    assert(cbOperands.size() >= 2 &&
+           "Expected input and output CBs for unary op.");
 
     auto inCB = cbOperands[0];
-    auto outCB = cbOperands[1];
+    auto outCB = cbOperands.back();
 
     // All unary ops have common init function and specialized init function.
     builder.create<ttkernel::UnaryOpInitCommonOp>(arithOrMathOp.getLoc(), inCB,
                                                   outCB);
+    convertInitSfpuOp(arithOrMathOp, builder);
+  }
 
+  // Specialized init of unary ops, which run on the SFPU in place on a tile
+  // in DST register.
+  void convertInitSfpuOp(Operation &arithOrMathOp, OpBuilder &builder) const {
     if (mlir::isa<math::ExpOp>(arithOrMathOp)) {
       builder.create<ttkernel::ExpTileInitOp>(arithOrMathOp.getLoc());
     } else {
@@ -674,15 +679,112 @@ public:
     }
   }
 
+  // Binary fused ops are initialized on every tile, right before they run.
+  void convertInitFusedOps(ArrayRef<Operation *> fusedOps,
+                           OpBuilder &builder) const {
+    for (Operation *fusedOp : fusedOps) {
+      if (fusedOp->getNumOperands() == 1) {
+        convertInitSfpuOp(*fusedOp, builder);
+      }
+    }
+  }
+
+  void convertComputeSfpuOp(Operation &arithOrMathOp, Value dstTileIndex,
+                            OpBuilder &builder) const {
+    if (mlir::isa<math::ExpOp>(arithOrMathOp)) {
+      builder.create<ttkernel::ExpTileOp>(arithOrMathOp.getLoc(),
+                                          dstTileIndex);
+    } else {
+      llvm_unreachable("Unhandled unary op compute conversion.");
+    }
+  }
+
+  // Binary op fused after the first op of a region. Its other operand is a
+  // block argument, read from the CB with the same argument number, and the
+  // tile in DST register is reused as operand A.
+  void convertComputeDestReuseOp(Operation &arithOrMathOp,
+                                 ArrayRef<BlockArgument> cbOperands,
+                                 ArrayRef<BlockArgument> iterators,
+                                 ArrayRef<unsigned> blockArgIteratorMapping,
+                                 Value dstTileIndex, OpBuilder &builder) const {
+    auto operand = llvm::find_if(arithOrMathOp.getOperands(), [](Value value) {
+      return mlir::isa<BlockArgument>(value);
+    });
+    assert(operand != arithOrMathOp.getOperands().end() &&
+           "Expected fused binary op to read one operand from CB");
+    unsigned argNumber = mlir::cast<BlockArgument>(*operand).getArgNumber();
+    auto inCB = cbOperands[argNumber];
+    auto inCBTileIndex = iterators[blockArgIteratorMapping[argNumber]];
+
+    ttkernel::EltwiseBinaryType eltwiseType;
+    if (mlir::isa<arith::AddFOp>(arithOrMathOp)) {
+      eltwiseType = ttkernel::EltwiseBinaryType::Add;
+    } else if (mlir::isa<arith::MulFOp>(arithOrMathOp)) {
+      eltwiseType = ttkernel::EltwiseBinaryType::Mul;
+    } else {
+      llvm_unreachable("Unhandled fused binary op conversion.");
+    }
+    auto eltwiseTypeAttr =
+        builder.getAttr<ttkernel::EltwiseBinaryTypeAttr>(eltwiseType);
+
+    builder.create<ttkernel::BinaryDestReuseTilesInitOp>(
+        arithOrMathOp.getLoc(), inCB, eltwiseTypeAttr);
+    builder.create<ttkernel::BinaryDestReuseTilesOp>(
+        arithOrMathOp.getLoc(), inCB, inCBTileIndex, dstTileIndex,
+        eltwiseTypeAttr);
+  }
+
+  // Ops fused after the first op of a region take its result tile in DST
+  // register and leave theirs in place, so the chain is packed once.
+  void convertComputeFusedOps(ArrayRef<Operation *> fusedOps,
+                              ArrayRef<BlockArgument> cbOperands,
+                              ArrayRef<BlockArgument> iterators,
+                              ArrayRef<unsigned> blockArgIteratorMapping,
+                              Value dstTileIndex, OpBuilder &builder) const {
+    for (Operation *fusedOp : fusedOps) {
+      if (fusedOp->getNumOperands() == 1) {
+        convertComputeSfpuOp(*fusedOp, dstTileIndex, builder);
+      } else {
+        convertComputeDestReuseOp(*fusedOp, cbOperands, iterators,
+                                  blockArgIteratorMapping, dstTileIndex,
+                                  builder);
+      }
+    }
+  }
+
+  // Binary fused ops leave unpacker and FPU configured to read from DST, so
+  // the first op is initialized again before every tile. Div initializes its
+  // tile ops on every tile already.
+  void convertReinitComputeOp(Operation &arithOrMathOp,
+                              ArrayRef<Operation *> fusedOps,
+                              ArrayRef<BlockArgument> cbOperands,
+                              OpBuilder &builder) const {
+    if (llvm::none_of(fusedOps, [](Operation *fusedOp) {
+          return fusedOp->getNumOperands() == 2;
+        })) {
+      return;
+    }
+
+    if (arithOrMathOp.getNumOperands() == 1) {
+      builder.create<ttkernel::CopyTileInitOp>(arithOrMathOp.getLoc());
+    } else if (mlir::isa<arith::AddFOp>(arithOrMathOp)) {
+      builder.create<ttkernel::AddTilesInitOp>(arithOrMathOp.getLoc(),
+                                               cbOperands[0], cbOperands[1]);
+    } else if (mlir::isa<arith::MulFOp>(arithOrMathOp)) {
+      builder.create<ttkernel::MulTilesInitOp>(arithOrMathOp.getLoc(),
+                                               cbOperands[0], cbOperands[1]);
+    }
+  }
+
   void convertInitBinaryOp(Operation &arithOrMathOp,
                            ArrayRef<BlockArgument> cbOperands,
                            OpBuilder &builder) const {
-    assert(cbOperands.size() == 3 &&
-           "Expected two input and one output CB for binary op.");
+    assert(cbOperands.size() >= 3 &&
+           "Expected two input and output CBs for binary op.");
 
     auto inCB0 = cbOperands[0];
     auto inCB1 = cbOperands[1];
-    auto outCB = cbOperands[2];
+    auto outCB = cbOperands.back();
 
     // All binary ops have common init function and specialized init function.
     builder.create<ttkernel::BinaryOpInitCommonOp>(arithOrMathOp.getLoc(),
@@ -708,11 +810,10 @@ public:
   // nest.
   void convertComputeInitOp(Operation &arithOrMathOp,
                             ArrayRef<BlockArgument> cbOperands,
-                            std::int64_t numDpsInputs,
                             OpBuilder &builder) const {
-    if (numDpsInputs == 1) {
+    if (arithOrMathOp.getNumOperands() == 1) {
       convertInitUnaryOp(arithOrMathOp, cbOperands, builder);
-    } else if (numDpsInputs == 2) {
+    } else if (arithOrMathOp.getNumOperands() == 2) {
       convertInitBinaryOp(arithOrMathOp, cbOperands, builder);
     } else {
       llvm_unreachable("Unhandled conversion for operation which is neither "
@@ -721,12 +822,13 @@ public:
   }
 
   void convertComputeUnaryOp(Operation &arithOrMathOp,
+                             ArrayRef<Operation *> fusedOps,
                              ArrayRef<BlockArgument> cbOperands,
                              ArrayRef<BlockArgument> iterators,
                              SmallVector<unsigned> blockArgIteratorMapping,
                              OpBuilder &builder) const {
-    assert(cbOperands.size() == 2 &&
-           "Expected one input and one output CB for unary op.");
+    assert(cbOperands.size() >= 2 &&
+           "Expected input and output CBs for unary op.");
 
     auto inCBTileIndex = iterators[blockArgIteratorMapping[0]];
     auto inCB = cbOperands[0];
@@ -748,11 +850,9 @@ public:
 
     // Perform computation on tile in DST register on dstTileIndex (the only
     // tile in DST).
-    if (mlir::isa<math::ExpOp>(arithOrMathOp)) {
-      builder.create<ttkernel::ExpTileOp>(location, dstTileIndex);
-    } else {
-      llvm_unreachable("Unhandled unary op compute conversion.");
-    }
+    convertComputeSfpuOp(arithOrMathOp, dstTileIndex, builder);
+    convertComputeFusedOps(fusedOps, cbOperands, iterators,
+                           blockArgIteratorMapping, dstTileIndex, builder);
 
     // MATH releases lock on DST.
     builder.create<ttkernel::TileRegsCommitOp>(location);
@@ -771,19 +871,20 @@ public:
   }
 
   void convertComputeBinaryOp(Operation &arithOrMathOp,
+                              ArrayRef<Operation *> fusedOps,
                               ArrayRef<BlockArgument> cbOperands,
                               ArrayRef<BlockArgument> iterators,
                               SmallVector<unsigned> blockArgIteratorMapping,
                               OpBuilder &builder) const {
-    assert(cbOperands.size() == 3 &&
-           "Expected two input and one output CB for binary op.");
+    assert(cbOperands.size() >= 3 &&
+           "Expected two input and output CBs for binary op.");
 
     auto inCB0TileIndex = iterators[blockArgIteratorMapping[0]];
     auto inCB0 = cbOperands[0];
     auto inCB1TileIndex = iterators[blockArgIteratorMapping[1]];
     auto inCB1 = cbOperands[1];
-    auto outCB = cbOperands[2];
-    auto outCBTileIndex = iterators[blockArgIteratorMapping[2]];
+    auto outCB = cbOperands.back();
+    auto outCBTileIndex = iterators[blockArgIteratorMapping.back()];
 
     auto location = arithOrMathOp.getLoc();
 
@@ -794,13 +895,15 @@ public:
       builder.create<ttkernel::TileRegsAcquireOp>(location);
       builder.create<ttkernel::AddTilesOp>(
           location, inCB0, inCB1, inCB0TileIndex, inCB1TileIndex, dstIndex);
+      convertComputeFusedOps(fusedOps, cbOperands, iterators,
+                             blockArgIteratorMapping, dstIndex, builder);
       builder.create<ttkernel::TileRegsCommitOp>(location);
       builder.create<ttkernel::TileRegsWaitOp>(location);
       builder.create<ttkernel::PackTileOp>(location, dstIndex, outCB,
                                            outCBTileIndex);
       builder.create<ttkernel::TileRegsReleaseOp>(location);
     } else if (mlir::isa<arith::MulFOp>(arithOrMathOp)) {
-      commonComputeMulOp(arithOrMathOp, cbOperands, iterators,
+      commonComputeMulOp(arithOrMathOp, fusedOps, cbOperands, iterators,
                          blockArgIteratorMapping, builder);
     } else if (mlir::isa<arith::DivFOp>(arithOrMathOp)) {
 
@@ -816,7 +919,10 @@ public:
 
       builder.create<ttkernel::MulTilesInitOp>(location, inCB0, inCB1);
 
-      commonComputeMulOp(arithOrMathOp, cbOperands, iterators,
+      // Reciprocal reprogrammed the SFPU, fused ops need their init again.
+      convertInitFusedOps(fusedOps, builder);
+
+      commonComputeMulOp(arithOrMathOp, fusedOps, cbOperands, iterators,
                          blockArgIteratorMapping, builder);
 
       builder.create<ttkernel::CBPopFrontOp>(location, inCB1, one);
@@ -826,16 +932,18 @@ public:
     }
   }
 
-  void commonComputeMulOp(Operation &op, ArrayRef<BlockArgument> cbOperands,
+  void commonComputeMulOp(Operation &op, ArrayRef<Operation *> fusedOps,
+                          ArrayRef<BlockArgument> cbOperands,
                           ArrayRef<BlockArgument> iterators,
                           SmallVector<unsigned> blockArgIteratorMapping,
                           OpBuilder &builder) const {
 
     auto inCB0 = cbOperands[0];
     auto inCB1 = cbOperands[1];
-    auto outCB = cbOperands[2];
+    auto outCB = cbOperands.back();
     auto inCB0TileIndex = iterators[blockArgIteratorMapping[0]];
     auto inCB1TileIndex = iterators[blockArgIteratorMapping[1]];
+    auto outCBTileIndex = iterators[blockArgIteratorMapping.back()];
 
     Value dstIndex = i32(0, builder);
 
@@ -852,11 +960,13 @@ public:
       llvm_unreachable("Common compute for multiplying tiles should be called "
                        "only on MulFOp and DivFOp");
     }
+    convertComputeFusedOps(fusedOps, cbOperands, iterators,
+                           blockArgIteratorMapping, dstIndex, builder);
 
     builder.create<ttkernel::TileRegsCommitOp>(op.getLoc());
     builder.create<ttkernel::TileRegsWaitOp>(op.getLoc());
     builder.create<ttkernel::PackTileOp>(op.getLoc(), dstIndex, outCB,
-                                         iterators[blockArgIteratorMapping[2]]);
+                                         outCBTileIndex);
     builder.create<ttkernel::TileRegsReleaseOp>(op.getLoc());
   }
 
@@ -892,16 +1002,18 @@ public:
   // The iterators are unique-ified so we need blockArgIteratorMapping to
   // recover which top level tensor operand is associated with which iterator.
   void convertComputeOp(Operation &arithOrMathOp,
+                        ArrayRef<Operation *> fusedOps,
                         ArrayRef<BlockArgument> cbOperands,
                         ArrayRef<BlockArgument> iterators,
                         SmallVector<unsigned> blockArgIteratorMapping,
-                        OpBuilder &builder, std::int64_t numDpsInputs) const {
+                        OpBuilder &builder) const {
+    convertReinitComputeOp(arithOrMathOp, fusedOps, cbOperands, builder);
 
-    if (numDpsInputs == 1) {
-      convertComputeUnaryOp(arithOrMathOp, cbOperands, iterators,
+    if (arithOrMathOp.getNumOperands() == 1) {
+      convertComputeUnaryOp(arithOrMathOp, fusedOps, cbOperands, iterators,
                             blockArgIteratorMapping, builder);
-    } else if (numDpsInputs == 2) {
-      convertComputeBinaryOp(arithOrMathOp, cbOperands, iterators,
+    } else if (arithOrMathOp.getNumOperands() == 2) {
+      convertComputeBinaryOp(arithOrMathOp, fusedOps, cbOperands, iterators,
                              blockArgIteratorMapping, builder);
     } else {
       llvm_unreachable("Unhandled conversion for operation which is neither "
@@ -911,16 +1023,17 @@ public:
 
   // Builds instructions to execute before looping over tiles has started.
   void buildInitSection(Operation &arithOrMathOp,
+                        ArrayRef<Operation *> fusedOps,
                         OpBuilder &dispatchBlockBuilder,
-                        ArrayRef<BlockArgument> cbOperands,
-                        std::int64_t numDPSInputs) const {
-    convertComputeInitOp(arithOrMathOp, cbOperands, numDPSInputs,
-                         dispatchBlockBuilder);
+                        ArrayRef<BlockArgument> cbOperands) const {
+    convertComputeInitOp(arithOrMathOp, cbOperands, dispatchBlockBuilder);
+    convertInitFusedOps(fusedOps, dispatchBlockBuilder);
   }
 
   // Builds nested loops which loop over tensor tiles after initalization is
   // done and computation to perform on each tile over which loops iterate.
   void buildLoopsAndComputation(Operation &arithOrMathOp,
+                                ArrayRef<Operation *> fusedOps,
                                 OpBuilder &dispatchBlockBuilder,
                                 ArrayRef<BlockArgument> &cbOperands,
                                 std::int64_t numDPSInputs) const {
@@ -942,8 +1055,8 @@ public:
 
     // Call compute function to execute on each tile. Result will be stored in
     // DST.
-    convertComputeOp(arithOrMathOp, cbOperands, iterators,
-                     blockArgIteratorMapping, innerLoopBuilder, numDPSInputs);
+    convertComputeOp(arithOrMathOp, fusedOps, cbOperands, iterators,
+                     blockArgIteratorMapping, innerLoopBuilder);
   }
 
   // Builds instructions to execute after loops are finished.
@@ -956,12 +1069,32 @@ public:
 
   // Convert the original block into a lowered block that contains a fully
   // expanded loop nest and inner loop that implements the underlying arith or
-  // math operation as a tile operation.
+  // math operation as a tile operation. Blocks fused by ttir-generic-fuse
+  // chain ops after the first op, each taking the previous result and at most
+  // one more input. The first op reads the leading inputs of the block.
   void lowerBlock(Block *origGenericOpBlock, Block *dispatchOpBlock,
                   std::int64_t numDPSInputs) const {
     Block::OpListType &operations = origGenericOpBlock->getOperations();
-    assert(operations.size() == 2);
-    Operation::user_range users = operations.front().getUsers();
+    assert(operations.size() >= 2);
+    Operation &arithOrMathOp = operations.front();
+    assert(llvm::all_of(llvm::enumerate(arithOrMathOp.getOperands()),
+                        [](auto operand) {
+                          auto arg = mlir::dyn_cast<BlockArgument>(
+                              operand.value());
+                          return arg && arg.getArgNumber() == operand.index();
+                        }) &&
+           "Expected first op to read the leading inputs");
+    SmallVector<Operation *> fusedOps;
+    for (Operation &fusedOp : origGenericOpBlock->without_terminator()) {
+      if (&fusedOp != &arithOrMathOp) {
+        assert((fusedOp.getNumOperands() == 1 ||
+                fusedOp.getNumOperands() == 2) &&
+               "Expected unary or binary ops after the first op");
+        fusedOps.push_back(&fusedOp);
+      }
+    }
+    Operation &lastOp = fusedOps.empty() ? arithOrMathOp : *fusedOps.back();
+    Operation::user_range users = lastOp.getUsers();
     assert(users.begin() != users.end());
     assert(mlir::isa<ttir::YieldOp>(*users.begin()));
     assert(dispatchOpBlock->getNumArguments() > numDPSInputs);
@@ -969,13 +1102,11 @@ public:
            "Expected 1 output");
 
     OpBuilder dispatchBlockBuilder(dispatchOpBlock, dispatchOpBlock->begin());
-    Operation &arithOrMathOp = operations.front();
     auto cbOperands = dispatchOpBlock->getArguments();
 
-    buildInitSection(arithOrMathOp, dispatchBlockBuilder, cbOperands,
-                     numDPSInputs);
-    buildLoopsAndComputation(arithOrMathOp, dispatchBlockBuilder, cbOperands,
-                             numDPSInputs);
+    buildInitSection(arithOrMathOp, fusedOps, dispatchBlockBuilder, cbOperands);
+    buildLoopsAndComputation(arithOrMathOp, fusedOps, dispatchBlockBuilder,
+                             cbOperands, numDPSInputs);
     buildEndSection(dispatchBlockBuilder, origGenericOpBlock);
   }
 
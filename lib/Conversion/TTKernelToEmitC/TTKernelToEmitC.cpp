@@ -107,6 +107,18 @@ emitc::OpaqueAttr convertCBPort(Builder &builder, ttkernel::CBPort port) {
   return nullptr;
 }
 
+emitc::OpaqueAttr convertEltwiseBinaryType(Builder &builder,
+                                           ttkernel::EltwiseBinaryType type) {
+  switch (type) {
+  case ttkernel::EltwiseBinaryType::Add:
+    return builder.getType<emitc::OpaqueAttr>("EltwiseBinaryType::ELWADD");
+  case ttkernel::EltwiseBinaryType::Mul:
+    return builder.getType<emitc::OpaqueAttr>("EltwiseBinaryType::ELWMUL");
+  }
+  llvm_unreachable("Unknown EltwiseBinaryType");
+  return nullptr;
+}
+
 class TTKernelToEmitCTypeConverter : public TypeConverter {
 public:
   TTKernelToEmitCTypeConverter(MLIRContext *ctx) {
@@ -187,6 +199,19 @@ public:
     return name;
   }
 
+  ArrayAttr getTemplateArgs(Builder &builder, SourceOp op) const {
+    // Tile in DST register is the first operand, A, of the binary op.
+    if constexpr (std::is_same_v<SourceOp,
+                                 ttkernel::BinaryDestReuseTilesInitOp> ||
+                  std::is_same_v<SourceOp, ttkernel::BinaryDestReuseTilesOp>) {
+      return builder.getArrayAttr(
+          {convertEltwiseBinaryType(builder, op.getEltwiseType()),
+           builder.getType<emitc::OpaqueAttr>(
+               "EltwiseBinaryReuseDestType::DEST_TO_SRCA")});
+    }
+    return ArrayAttr();
+  }
+
   LogicalResult
   matchAndRewrite(SourceOp op, Adaptor adaptor,
                   ConversionPatternRewriter &rewriter) const final {
@@ -199,8 +224,8 @@ public:
       resultTypes.push_back(ct);
     }
     rewriter.replaceOpWithNewOp<emitc::CallOpaqueOp>(
-        op, resultTypes, getOpName(op), nullptr, nullptr,
-        adaptor.getOperands());
+        op, resultTypes, getOpName(op), nullptr,
+        getTemplateArgs(rewriter, op), adaptor.getOperands());
     return success();
   }
 };
@@ -283,6 +308,9 @@ public:
                TTMetalToEmitCOpaqueRewriter<ttkernel::MulTilesInitFOp>,
                TTMetalToEmitCOpaqueRewriter<ttkernel::AddTilesOp>,
                TTMetalToEmitCOpaqueRewriter<ttkernel::MulTilesOp>,
+               TTMetalToEmitCOpaqueRewriter<
+                   ttkernel::BinaryDestReuseTilesInitOp>,
+               TTMetalToEmitCOpaqueRewriter<ttkernel::BinaryDestReuseTilesOp>,
                TTMetalToEmitCOpaqueRewriter<ttkernel::GetNocAddrOp>,
                TTMetalToEmitCOpaqueRewriter<ttkernel::NocAsyncReadOp>,
                TTMetalToEmitCOpaqueRewriter<ttkernel::NocAsyncReadBarrierOp>,
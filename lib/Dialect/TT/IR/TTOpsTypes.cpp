@@ -636,6 +636,25 @@ LayoutAttr LayoutAttr::withMemoryLayout(::mlir::MLIRContext *context,
       memLayout);
 }
 
+// Device ops work on tiles even if the tensor is not tiled yet, so the shard
+// of every core is rounded up to whole tiles. Scalar ceil division alone would
+// split tiles across cores when the grid doesn't divide the tensor. Last core
+// along a dim then holds the remainder of the tensor.
+LayoutAttr LayoutAttr::withTileAlignedShardShape(::mlir::MLIRContext *context) {
+  SmallVector<int64_t> shardShape = getShardShape();
+  if (isTiled() or shardShape.size() < 2) {
+    return *this;
+  }
+
+  TileType tileType = TileType::get(context, getElementType());
+  return LayoutAttr::get(
+      context, getLinear(), getOobVal(), getGrid(),
+      buildMemRef(context,
+                  tileType.getScalarShape(tileType.getTiledShape(shardShape)),
+                  getElementType(), getMemorySpace()),
+      getMemLayout());
+}
+
 MemorySpace LayoutAttr::getMemorySpace() const {
   return mlir::cast<mlir::tt::MemorySpaceAttr>(getMemref().getMemorySpace())
       .getValue();
@@ -971,6 +990,14 @@ uint64_t DeviceAttr::getLayoutSizeBytes(ArrayRef<int64_t> tensorScalarShape,
       layout.isTiled() ? layout.getIdentityTileLinearMap() : layout.getLinear();
   mlir::SmallVector<std::int64_t> linearShape =
       ttmlir::utils::evalShape(linearMap, shape);
+  // Every core allocates a whole shard, while the last core of an uneven grid
+  // only holds a partial one. Sample the last element of the first shard.
+  if (isL1MemorySpace(memorySpace)) {
+    SmallVector<int64_t> shardShape = layout.getShardShape(false);
+    for (size_t i = 0; i < linearShape.size(); ++i) {
+      linearShape[i] = std::min(linearShape[i], shardShape[i]);
+    }
+  }
   AffineMap memoryMap = layout.replaceMemoryMapSymbolsWithShardShape(
       getMapForMemorySpace(memorySpace));
   mlir::SmallVector<std::int64_t> physicalMemory =
@@ -0,0 +1,305 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/DAGShardingPolicy.h"
+#include "ttmlir/Dialect/TTIR/Analysis/L1Usage.h"
+#include "ttmlir/Dialect/TTIR/IR/TTIROps.h"
+#include "ttmlir/Scheduler/Scheduler.h"
+
+namespace mlir::tt::ttir {
+
+// Schedules ops depth first. Prefers users of the last scheduled op to keep
+// live ranges of sharded tensors short, then ttir.to_layout ops.
+//
+llvm::SmallVector<Operation *>
+DAGShardingPolicy::scheduleFunc(func::FuncOp func) {
+  mlir::tt::scheduler::Scheduler scheduler(&func);
+  Operation *lastOp = nullptr;
+
+  auto priority = [&lastOp](Operation *op) -> int64_t {
+    if (lastOp && llvm::is_contained(op->getOperands(), lastOp->getResult(0))) {
+      return 2;
+    }
+
+    return isa<ttir::ToLayoutOp>(op) ? 1 : 0;
+  };
+
+  while (scheduler.hasUnscheduledOps()) {
+    lastOp = scheduler.getNextScheduleableOp(priority);
+    scheduler.scheduleOp(lastOp);
+  }
+
+  return scheduler.getSchedule();
+}
+
+uint64_t DAGShardingPolicy::getOutputL1Usage(Operation *op,
+                                             LayoutAttr layout) {
+  assert(layout.hasShardedL1TensorMemoryLayout());
+  return layoutSizeCache->getLayoutSizeBytes(
+      getCurrentScopeDevice(op),
+      mlir::cast<RankedTensorType>(op->getResult(0).getType()).getShape(),
+      layout, layout.getMemorySpace());
+}
+
+void DAGShardingPolicy::resetLiveL1Usage() {
+  liveFunc = nullptr;
+  livePos = 0;
+  nextL1ResidentOp = 0;
+  liveL1Ops.clear();
+  liveL1Expiry = decltype(liveL1Expiry)();
+  liveL1Usage = 0;
+  liveUsedOutsideL1Usage = 0;
+}
+
+// L1 used at the op's position in the schedule by sharded tensors produced
+// earlier in the same func which still have users left. With spilling, only
+// operands of the op and tensors used outside of the schedule have to stay,
+// the rest can be spilled to DRAM around the op.
+//
+// Ops are queried in schedule order, so live tensors are tracked
+// incrementally: each L1 resident op enters the live set once, when the
+// query position passes it, and leaves it once, after its last user. Query
+// at an earlier position or in another func starts over.
+//
+uint64_t DAGShardingPolicy::getLiveL1Usage(Operation *op) {
+  int64_t pos = schedulePos.lookup(op);
+  if (op->getParentOp() != liveFunc || pos < livePos) {
+    resetLiveL1Usage();
+    liveFunc = op->getParentOp();
+  }
+  livePos = pos;
+
+  const llvm::SmallVector<Operation *> &funcL1ResidentOps =
+      l1ResidentOps[liveFunc];
+  while (nextL1ResidentOp < funcL1ResidentOps.size() &&
+         schedulePos.lookup(funcL1ResidentOps[nextL1ResidentOp]) < pos) {
+    Operation *l1Op = funcL1ResidentOps[nextL1ResidentOp++];
+    uint64_t opL1Usage = l1Usage.lookup(l1Op);
+    liveL1Ops[l1Op] = opL1Usage;
+    liveL1Expiry.push({lastUsePos.lookup(l1Op), l1Op});
+    liveL1Usage += opL1Usage;
+    if (usedOutsideOps.contains(l1Op)) {
+      liveUsedOutsideL1Usage += opL1Usage;
+    }
+  }
+
+  while (!liveL1Expiry.empty() && liveL1Expiry.top().first < pos) {
+    Operation *l1Op = liveL1Expiry.top().second;
+    liveL1Expiry.pop();
+    liveL1Usage -= liveL1Ops.lookup(l1Op);
+    liveL1Ops.erase(l1Op);
+  }
+
+  if (!l1SpillEnabled) {
+    return liveL1Usage;
+  }
+
+  uint64_t operandsL1Usage = 0;
+  llvm::SmallPtrSet<Operation *, 4> seenOperandOps;
+  for (Value operand : op->getOperands()) {
+    Operation *l1Op = operand.getDefiningOp();
+    auto liveL1Op = liveL1Ops.find(l1Op);
+    if (liveL1Op != liveL1Ops.end() && !usedOutsideOps.contains(l1Op) &&
+        seenOperandOps.insert(l1Op).second) {
+      operandsL1Usage += liveL1Op->second;
+    }
+  }
+
+  return liveUsedOutsideL1Usage + operandsL1Usage;
+}
+
+void DAGShardingPolicy::run() {
+  rootOp->walk([&](func::FuncOp func) {
+    llvm::SmallVector<Operation *> funcSchedule = scheduleFunc(func);
+    (*schedule)[func] = funcSchedule;
+
+    for (size_t i = 0; i < funcSchedule.size(); ++i) {
+      schedulePos[funcSchedule[i]] = i;
+    }
+
+    // Users outside of the schedule (func.return) keep the tensor alive until
+    // the end of the func.
+    //
+    for (Operation *op : funcSchedule) {
+      int64_t lastUse = schedulePos[op];
+      for (Operation *user : op->getResult(0).getUsers()) {
+        auto userPos = schedulePos.find(user);
+        lastUse = std::max(lastUse, userPos != schedulePos.end()
+                                        ? userPos->second
+                                        : static_cast<int64_t>(
+                                              funcSchedule.size()));
+      }
+      lastUsePos[op] = lastUse;
+      if (lastUse == static_cast<int64_t>(funcSchedule.size())) {
+        usedOutsideOps.insert(op);
+      }
+    }
+
+    // Try to add op to the current subgraph. Op fits if its first legal
+    // layout, the cheapest one or the one with the largest grid without a
+    // cost model, fits into L1 next to all live sharded tensors. Subgraph can
+    // only start with an op which fits with its first input resharded to L1.
+    //
+    llvm::DenseSet<Operation *> subgraphOps;
+    auto tryAddOp = [&](Operation *op) {
+      LayoutAttr opLayout = legalLayouts.lookup(op).front();
+      uint64_t opL1Usage = getOutputL1Usage(op, opLayout);
+      uint64_t requiredL1Usage =
+          getLiveL1Usage(op) + opL1Usage + getOpL1ExecUsage(op, opLayout);
+
+      if (shardChainConfigs->back().isEmpty()) {
+        Operation *firstInputOp = op->getOperand(0).getDefiningOp();
+        if (!firstInputOp) {
+          return false;
+        }
+
+        RankedTensorType firstInputType =
+            mlir::cast<RankedTensorType>(firstInputOp->getResult(0).getType());
+        LayoutAttr firstInputShardedLayout =
+            mlir::cast<LayoutAttr>(firstInputType.getEncoding())
+                .withMemorySpace(op->getContext(), opLayout.getMemorySpace())
+                .withMemoryLayout(op->getContext(), opLayout.getMemLayout())
+                .withGrid(op->getContext(), firstInputType,
+                          opLayout.getGrid())
+                .withTileAlignedShardShape(op->getContext());
+        requiredL1Usage += layoutSizeCache->getLayoutSizeBytes(
+            getCurrentScopeDevice(op), firstInputType.getShape(),
+            firstInputShardedLayout,
+            firstInputShardedLayout.getMemorySpace());
+      }
+
+      if (requiredL1Usage >= usableL1CacheSize) {
+        return false;
+      }
+
+      ShardSpec shardSpec;
+      shardSpec.op = op;
+      shardSpec.tensorSplitFactor = 1;
+      shardChainConfigs->back().addShardSpec(std::move(shardSpec));
+      subgraphOps.insert(op);
+      l1ResidentOps[op->getParentOp()].push_back(op);
+      l1Usage[op] = opL1Usage;
+      return true;
+    };
+
+    auto closeSubgraph = [&]() {
+      if (!shardChainConfigs->back().isEmpty()) {
+        shardChainConfigs->back().build();
+        shardChainConfigs->push_back(ShardChainConfig());
+        subgraphOps.clear();
+      }
+    };
+
+    auto isConnectedToSubgraph = [&](Operation *op) {
+      return llvm::any_of(op->getOperands(),
+                          [&](Value operand) {
+                            return subgraphOps.contains(
+                                operand.getDefiningOp());
+                          }) ||
+             llvm::any_of(op->getResult(0).getUsers(), [&](Operation *user) {
+               return subgraphOps.contains(user);
+             });
+    };
+
+    shardChainConfigs->push_back(ShardChainConfig());
+    for (Operation *op : funcSchedule) {
+      // Ops which can't be sharded, ttir.to_layout among them, stay out of
+      // subgraphs but don't end the current one, ops after them may still
+      // join it.
+      //
+      if (isa<ttir::ToLayoutOp>(op) || legalLayouts.lookup(op).empty()) {
+        continue;
+      }
+
+      // Op sharing no edge with the current subgraph starts a new one.
+      //
+      if (!shardChainConfigs->back().isEmpty() && !isConnectedToSubgraph(op)) {
+        closeSubgraph();
+      }
+
+      if (tryAddOp(op)) {
+        continue;
+      }
+
+      // Op does not fit into current subgraph, try starting a new one.
+      //
+      bool subgraphWasEmpty = shardChainConfigs->back().isEmpty();
+      closeSubgraph();
+      if (!subgraphWasEmpty && tryAddOp(op)) {
+        continue;
+      }
+    }
+    closeSubgraph();
+  });
+
+  if (shardChainConfigs->back().isEmpty()) {
+    shardChainConfigs->pop_back();
+  }
+
+  resetLiveL1Usage();
+  resolveShardChains();
+}
+
+// Picks layouts in schedule order. Cheapest valid layout which keeps live L1
+// usage within budget is taken. If none fits, layout with the smallest L1
+// footprint is taken.
+//
+void DAGShardingPolicy::pickOpLayouts(const ShardChainConfig &shardChainConfig,
+                                      ShardSolver &shardSolver) {
+  llvm::DenseMap<Operation *, LayoutAttr> selectedOpLayout;
+  for (const auto &shardSpec : shardChainConfig.getShardSpecs()) {
+    Operation *op = shardSpec.op;
+    uint64_t liveL1Usage = getLiveL1Usage(op);
+
+    // Tuned layout is reused only if it still fits next to live tensors.
+    //
+    LayoutAttr tunedLayout = getTunedLayout(op, shardSolver);
+    if (tunedLayout &&
+        liveL1Usage + getOutputL1Usage(op, tunedLayout) +
+                getOpL1ExecUsage(op, tunedLayout) <
+            usableL1CacheSize) {
+      l1Usage[op] = getOutputL1Usage(op, tunedLayout);
+      selectedOpLayout[op] = tunedLayout;
+      shardSolver.set(op, tunedLayout);
+      continue;
+    }
+
+    LayoutAttr bestLayout;
+    double bestCost = 0;
+    LayoutAttr smallestLayout;
+    uint64_t smallestL1Usage = 0;
+    for (LayoutAttr layout : shardSolver.at(op)) {
+      uint64_t opL1Usage = getOutputL1Usage(op, layout);
+      if (!smallestLayout || opL1Usage < smallestL1Usage) {
+        smallestLayout = layout;
+        smallestL1Usage = opL1Usage;
+      }
+
+      if (liveL1Usage + opL1Usage + getOpL1ExecUsage(op, layout) >=
+          usableL1CacheSize) {
+        continue;
+      }
+
+      double cost = costModel ? costModel->getOpCost(op, layout) +
+                                    getIncomingReshardCost(op, layout,
+                                                           shardSolver,
+                                                           selectedOpLayout)
+                              : 0;
+      if (!bestLayout || cost < bestCost) {
+        bestLayout = layout;
+        bestCost = cost;
+      }
+    }
+
+    if (!bestLayout) {
+      bestLayout = smallestLayout;
+    }
+
+    l1Usage[op] = getOutputL1Usage(op, bestLayout);
+    selectedOpLayout[op] = bestLayout;
+    shardSolver.set(op, bestLayout);
+  }
+}
+
+} // namespace mlir::tt::ttir
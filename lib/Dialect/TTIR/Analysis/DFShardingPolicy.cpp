@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "ttmlir/Dialect/TTIR/Analysis/DFShardingPolicy.h"
+#include "ttmlir/Dialect/TTIR/Analysis/L1Usage.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TensorSplit.h"
 #include "ttmlir/Dialect/TTIR/IR/TTIROps.h"
 #include "ttmlir/Scheduler/Scheduler.h"
 
@@ -10,11 +12,11 @@ namespace mlir::tt::ttir {
 
 void DFShardingPolicy::run() {
   rootOp->walk([&](func::FuncOp func) {
-    DeviceAttr deviceAttr = getCurrentScopeDevice(func);
     mlir::tt::scheduler::Scheduler scheduler(&func);
     shardChainConfigs->push_back(ShardChainConfig());
     llvm::SmallVector<mlir::Operation *> scheduleableOps;
     Operation *currentOp = nullptr;
+    unsigned chainSplitFactor = 1;
 
     // Produce shard chain configs.
     // 1. Schedule ops in DFS order.
@@ -82,91 +84,40 @@ void DFShardingPolicy::run() {
                                   legalLayouts.lookup(nextOp).size() > 0;
 
           if (validForSharding) {
-            // Fetch largest legal sharded L1 layouts for currentOp and nextOp.
-            //
-            // Calculate L1 tensor memory usage based on :
-            // currentOp output tensor shard spec, nextOp exec and nextOp output
-            // tensor.
+            // Fetch largest legal sharded L1 layouts for currentOp and nextOp
+            // and find the smallest tensor split factor with which both fit
+            // into L1. Split factor of the chain only grows, all of its ops
+            // are streamed in the same number of slices.
             //
             LayoutAttr currentOpLayout = legalLayouts.lookup(currentOp).front();
             assert(currentOpLayout.hasShardedL1TensorMemoryLayout());
-            llvm::ArrayRef<int64_t> currentOpOutputTensorShape =
-                mlir::cast<RankedTensorType>(currentOp->getResult(0).getType())
-                    .getShape();
-            uint64_t currentOpL1OutputUsage = deviceAttr.getLayoutSizeBytes(
-                currentOpOutputTensorShape, currentOpLayout,
-                currentOpLayout.getMemorySpace());
-
             LayoutAttr nextOpLayout = legalLayouts.lookup(nextOp).front();
             assert(nextOpLayout.hasShardedL1TensorMemoryLayout());
-            llvm::ArrayRef<int64_t> nextOpOutputTensorShape =
-                mlir::cast<RankedTensorType>(nextOp->getResult(0).getType())
-                    .getShape();
-            uint64_t nextOpL1OutputUsage = deviceAttr.getLayoutSizeBytes(
-                nextOpOutputTensorShape, nextOpLayout,
-                nextOpLayout.getMemorySpace());
-
-            // Figure out this const based on exec data, but will be replaced
-            // with API.
-            //
-            constexpr float tensorL1UsageCap = 0.8;
-            bool l1UsageValid = (currentOpL1OutputUsage + nextOpL1OutputUsage) <
-                                tensorL1UsageCap * usableL1CacheSize;
-
-            if (l1UsageValid) {
-              // TODO(nobradovic)
-              // It seems that bunch of TTNN ops have constraints which prevent
-              // them from being sharded if both inputs are interleaved,
-              // so proposal for now is starting a shard chain
-              // with reshard op(at later phase only when necessary based on op
-              // type) For this reason we also need to validate that currentOp
-              // can fit into L1 with its first input sharded.
-              //
-              bool firstInputL1UsageValid = true;
-              if (shardChainConfigs->back().isEmpty()) {
-                RankedTensorType firstOpInputTensorType =
-                    mlir::cast<RankedTensorType>(currentOp->getOperand(0)
-                                                     .getDefiningOp()
-                                                     ->getResult(0)
-                                                     .getType());
-                LayoutAttr firstOpInputLayout = mlir::cast<LayoutAttr>(
-                    firstOpInputTensorType.getEncoding());
-
-                LayoutAttr firstOpInputShardedLayout =
-                    firstOpInputLayout
-                        .withMemorySpace(currentOp->getContext(),
-                                         currentOpLayout.getMemorySpace())
-                        .withMemoryLayout(currentOp->getContext(),
-                                          currentOpLayout.getMemLayout())
-                        .withGrid(currentOp->getContext(),
-                                  firstOpInputTensorType,
-                                  currentOpLayout.getGrid());
-
-                uint64_t firstInputL1Usage = deviceAttr.getLayoutSizeBytes(
-                    firstOpInputTensorType.getShape(),
-                    firstOpInputShardedLayout,
-                    firstOpInputShardedLayout.getMemorySpace());
-
-                firstInputL1UsageValid =
-                    (firstInputL1Usage + currentOpL1OutputUsage) <
-                    tensorL1UsageCap * usableL1CacheSize;
-              }
 
-              if (firstInputL1UsageValid) {
-                // Add to shard chain config.
-                //
-                ShardSpec shardSpec;
-                shardSpec.op = currentOp;
-
-                // Hardcoded tensor split factor for now, until pipeline OP
-                // support is added.
-                //
-                shardSpec.tensorSplitFactor = 1;
-                shardChainConfigs->back().addShardSpec(std::move(shardSpec));
-                currentOp = nextOp;
-                continue;
+            bool isChainStart = shardChainConfigs->back().isEmpty();
+            std::optional<unsigned> pairSplitFactor;
+            for (unsigned splitFactor = chainSplitFactor;
+                 splitFactor <= kMaxTensorSplitFactor; ++splitFactor) {
+              if (isValidChainSplitFactor(shardChainConfigs->back(), currentOp,
+                                          nextOp, splitFactor) &&
+                  fitsInL1(currentOp, currentOpLayout, nextOp, nextOpLayout,
+                           isChainStart, splitFactor)) {
+                pairSplitFactor = splitFactor;
+                break;
               }
             }
+
+            if (pairSplitFactor) {
+              // Add to shard chain config.
+              //
+              ShardSpec shardSpec;
+              shardSpec.op = currentOp;
+              shardSpec.tensorSplitFactor = *pairSplitFactor;
+              chainSplitFactor = *pairSplitFactor;
+              shardChainConfigs->back().addShardSpec(std::move(shardSpec));
+              currentOp = nextOp;
+              continue;
+            }
           }
         }
 
@@ -174,8 +125,10 @@ void DFShardingPolicy::run() {
       }
 
       if (!shardChainConfigs->back().isEmpty()) {
+        shardChainConfigs->back().setTensorSplitFactor(chainSplitFactor);
         shardChainConfigs->back().build();
         shardChainConfigs->push_back(ShardChainConfig());
+        chainSplitFactor = 1;
       }
     }
 
@@ -186,25 +139,240 @@ void DFShardingPolicy::run() {
     shardChainConfigs->pop_back();
   }
 
-  // Resolve shard chain configs.
+  resolveShardChains();
+}
+
+// Split factor has to be valid for every tensor streamed through the chain:
+// outputs of chain ops, output of the next op and the chain input. Every op of
+// the chain, including ops added with split factor 1, is streamed in the same
+// number of slices, so all of them have to be splittable.
+//
+bool DFShardingPolicy::isValidChainSplitFactor(
+    const ShardChainConfig &shardChainConfig, Operation *currentOp,
+    Operation *nextOp, unsigned splitFactor) const {
+  if (splitFactor == 1) {
+    return true;
+  }
+
+  auto isValidOutputSplitFactor = [&](Operation *op) {
+    return canSplitAlongOuterDim(op) &&
+           isValidSplitFactor(
+               mlir::cast<RankedTensorType>(op->getResult(0).getType()),
+               legalLayouts.lookup(op).front(), splitFactor);
+  };
+
+  for (const ShardSpec &shardSpec : shardChainConfig.getShardSpecs()) {
+    if (!isValidOutputSplitFactor(shardSpec.op)) {
+      return false;
+    }
+  }
+
+  Operation *firstOp = shardChainConfig.getShardSpecs().empty()
+                           ? currentOp
+                           : shardChainConfig.getShardSpecs().front().op;
+  RankedTensorType firstOpInputTensorType =
+      mlir::cast<RankedTensorType>(firstOp->getOperand(0).getType());
+  return isValidOutputSplitFactor(currentOp) &&
+         isValidOutputSplitFactor(nextOp) &&
+         isValidSplitFactor(
+             firstOpInputTensorType,
+             mlir::cast<LayoutAttr>(firstOpInputTensorType.getEncoding()),
+             splitFactor);
+}
+
+uint64_t DFShardingPolicy::getSplitOutputL1Usage(Operation *op,
+                                                 LayoutAttr layout,
+                                                 unsigned splitFactor) const {
+  llvm::ArrayRef<int64_t> tensorShape =
+      mlir::cast<RankedTensorType>(op->getResult(0).getType()).getShape();
+  LayoutAttr splitLayout =
+      getSplitLayout(op->getContext(), tensorShape, layout, splitFactor);
+  return layoutSizeCache->getLayoutSizeBytes(
+      getCurrentScopeDevice(op), getSplitShape(tensorShape, splitFactor),
+      splitLayout, splitLayout.getMemorySpace());
+}
+
+// Calculate L1 tensor memory usage of one slice based on: currentOp output
+// tensor shard spec, nextOp exec and nextOp output tensor.
+//
+bool DFShardingPolicy::fitsInL1(Operation *currentOp,
+                                LayoutAttr currentOpLayout, Operation *nextOp,
+                                LayoutAttr nextOpLayout, bool isChainStart,
+                                unsigned splitFactor) const {
+  uint64_t currentOpL1OutputUsage =
+      getSplitOutputL1Usage(currentOp, currentOpLayout, splitFactor);
+  uint64_t nextOpL1OutputUsage =
+      getSplitOutputL1Usage(nextOp, nextOpLayout, splitFactor);
+  uint64_t nextOpL1ExecUsage = getOpL1ExecUsage(
+      nextOp,
+      getSplitLayout(
+          nextOp->getContext(),
+          mlir::cast<RankedTensorType>(nextOp->getResult(0).getType())
+              .getShape(),
+          nextOpLayout, splitFactor));
+  if (currentOpL1OutputUsage + nextOpL1OutputUsage + nextOpL1ExecUsage >=
+      usableL1CacheSize) {
+    return false;
+  }
+
+  if (!isChainStart) {
+    return true;
+  }
+
+  // TODO(nobradovic)
+  // It seems that bunch of TTNN ops have constraints which prevent
+  // them from being sharded if both inputs are interleaved,
+  // so proposal for now is starting a shard chain
+  // with reshard op(at later phase only when necessary based on op
+  // type) For this reason we also need to validate that currentOp
+  // can fit into L1 with its first input sharded.
   //
+  RankedTensorType firstOpInputTensorType =
+      mlir::cast<RankedTensorType>(currentOp->getOperand(0)
+                                       .getDefiningOp()
+                                       ->getResult(0)
+                                       .getType());
+  llvm::SmallVector<int64_t> firstOpInputSplitShape =
+      getSplitShape(firstOpInputTensorType.getShape(), splitFactor);
+  LayoutAttr firstOpInputLayout =
+      mlir::cast<LayoutAttr>(firstOpInputTensorType.getEncoding());
+
+  LayoutAttr firstOpInputShardedLayout =
+      firstOpInputLayout
+          .withMemorySpace(currentOp->getContext(),
+                           currentOpLayout.getMemorySpace())
+          .withMemoryLayout(currentOp->getContext(),
+                            currentOpLayout.getMemLayout())
+          .withGrid(currentOp->getContext(), firstOpInputSplitShape,
+                    currentOpLayout.getGrid())
+          .withTileAlignedShardShape(currentOp->getContext());
+
+  uint64_t firstInputL1Usage = layoutSizeCache->getLayoutSizeBytes(
+      getCurrentScopeDevice(currentOp), firstOpInputSplitShape,
+      firstOpInputShardedLayout, firstOpInputShardedLayout.getMemorySpace());
+
+  return (firstInputL1Usage + currentOpL1OutputUsage +
+          getOpL1ExecUsage(currentOp,
+                           getSplitLayout(currentOp->getContext(),
+                                          mlir::cast<RankedTensorType>(
+                                              currentOp->getResult(0).getType())
+                                              .getShape(),
+                                          currentOpLayout, splitFactor))) <
+         usableL1CacheSize;
+}
+
+void DFShardingPolicy::resolveShardChains() {
   for (auto &shardChainConfig : *shardChainConfigs) {
     ShardSolver shardSolver =
-        shardChainConfig.resolve(legalLayouts, usableL1CacheSize);
+        shardChainConfig.resolve(legalLayouts, usableL1CacheSize,
+                                 layoutSizeCache);
 
-    // TODO(nobradovic)
-    // For now dummy fetch first legal(largest grid) for shard spec.
+    // Ops of a chain without solution keep their default layouts.
     //
-    for (const auto &shardSpec : shardChainConfig.getShardSpecs()) {
-      Operation *op = shardSpec.op;
-      auto validLayouts = shardSolver.at(op);
-      shardSolver.set(op, *validLayouts.begin());
+    if (shardChainConfig.getState() == ShardChainState::Failed) {
+      continue;
     }
 
+    pickOpLayouts(shardChainConfig, shardSolver);
+
     ShardSolverSolution resolvedShardSolution = shardSolver.finish();
     shardChainConfig.complete(resolvedShardSolution.selectedOpLayout,
                               resolvedShardSolution.reshardedEdges);
   }
 }
 
+void DFShardingPolicy::pickOpLayouts(const ShardChainConfig &shardChainConfig,
+                                     ShardSolver &shardSolver) {
+  llvm::DenseMap<Operation *, LayoutAttr> selectedOpLayout;
+  for (const auto &shardSpec : shardChainConfig.getShardSpecs()) {
+    Operation *op = shardSpec.op;
+    LayoutAttr layout = pickOpLayout(op, shardSolver, selectedOpLayout);
+    selectedOpLayout[op] = layout;
+    shardSolver.set(op, layout);
+  }
+}
+
+// Cost of reshards on resharded incoming edges of the op if its output is in
+// given layout. Producers without selected layout keep their current one.
+//
+double DFShardingPolicy::getIncomingReshardCost(
+    Operation *op, LayoutAttr layout, const ShardSolver &shardSolver,
+    const llvm::DenseMap<Operation *, LayoutAttr> &selectedOpLayout,
+    Operation *skipProducerOp) {
+  double cost = 0;
+  for (size_t operandIndex = 0; operandIndex < op->getNumOperands();
+       operandIndex++) {
+    Value operand = op->getOperand(operandIndex);
+    Operation *producerOp = operand.getDefiningOp();
+    if (!producerOp || producerOp == skipProducerOp ||
+        !shardSolver.isResharded(Edge(producerOp, op, operandIndex))) {
+      continue;
+    }
+
+    RankedTensorType operandType =
+        mlir::cast<RankedTensorType>(operand.getType());
+    LayoutAttr producerLayout = selectedOpLayout.lookup(producerOp);
+    if (!producerLayout) {
+      producerLayout = mlir::cast<LayoutAttr>(operandType.getEncoding());
+    }
+
+    cost += costModel->getReshardCost(operandType, producerLayout, layout);
+  }
+
+  return cost;
+}
+
+LayoutAttr DFShardingPolicy::getTunedLayout(
+    Operation *op, const ShardSolver &shardSolver) const {
+  if (!tuningDatabase) {
+    return nullptr;
+  }
+
+  std::optional<TuningRecord> tuned = tuningDatabase->lookup(op);
+  if (!tuned) {
+    return nullptr;
+  }
+
+  for (LayoutAttr layout : shardSolver.at(op)) {
+    if (layout == tuned->layout) {
+      return layout;
+    }
+  }
+
+  return nullptr;
+}
+
+// Picks the tuned layout if there is one, otherwise the cheapest of the
+// layouts still valid for the op, including reshard cost on its resharded
+// incoming edges. Ties and missing cost model keep the solver order, which is
+// largest grid first.
+//
+LayoutAttr DFShardingPolicy::pickOpLayout(
+    Operation *op, const ShardSolver &shardSolver,
+    const llvm::DenseMap<Operation *, LayoutAttr> &selectedOpLayout) {
+  if (LayoutAttr tunedLayout = getTunedLayout(op, shardSolver)) {
+    return tunedLayout;
+  }
+
+  auto validLayouts = shardSolver.at(op);
+  if (not costModel) {
+    return *validLayouts.begin();
+  }
+
+  LayoutAttr bestLayout;
+  double bestCost = 0;
+  for (LayoutAttr layout : validLayouts) {
+    double cost =
+        costModel->getOpCost(op, layout) +
+        getIncomingReshardCost(op, layout, shardSolver, selectedOpLayout);
+
+    if (!bestLayout || cost < bestCost) {
+      bestLayout = layout;
+      bestCost = cost;
+    }
+  }
+
+  return bestLayout;
+}
+
 } // namespace mlir::tt::ttir
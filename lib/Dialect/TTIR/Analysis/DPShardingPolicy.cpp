@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/DPShardingPolicy.h"
+#include <limits>
+
+namespace mlir::tt::ttir {
+
+void DPShardingPolicy::pickOpLayouts(const ShardChainConfig &shardChainConfig,
+                                     ShardSolver &shardSolver) {
+  // Without cost model every assignment is equally good.
+  //
+  if (not costModel) {
+    DFShardingPolicy::pickOpLayouts(shardChainConfig, shardSolver);
+    return;
+  }
+
+  // Tuned layouts are a preference. If tuned layouts of neighbouring ops are
+  // not a valid pair, pick among all layouts left by the solver.
+  //
+  llvm::SmallVector<LayoutAttr> selectedLayouts;
+  if (!pickChainLayouts(shardChainConfig, shardSolver, /*tunedOnly=*/true,
+                        selectedLayouts) &&
+      !pickChainLayouts(shardChainConfig, shardSolver, /*tunedOnly=*/false,
+                        selectedLayouts)) {
+    DFShardingPolicy::pickOpLayouts(shardChainConfig, shardSolver);
+    return;
+  }
+
+  const std::vector<ShardSpec> &shardSpecs = shardChainConfig.getShardSpecs();
+  for (size_t i = 0; i < shardSpecs.size(); ++i) {
+    shardSolver.set(shardSpecs[i].op, selectedLayouts[i]);
+  }
+}
+
+bool DPShardingPolicy::pickChainLayouts(
+    const ShardChainConfig &shardChainConfig, const ShardSolver &shardSolver,
+    bool tunedOnly, llvm::SmallVector<LayoutAttr> &selectedLayouts) {
+  constexpr double kInfeasible = std::numeric_limits<double>::infinity();
+  const std::vector<ShardSpec> &shardSpecs = shardChainConfig.getShardSpecs();
+  const llvm::DenseMap<Operation *, LayoutAttr> noSelectedOpLayout;
+
+  // For every op in the chain: candidate layouts, cost of the cheapest chain
+  // prefix ending in each candidate and the predecessor candidate on it.
+  //
+  std::vector<llvm::SmallVector<LayoutAttr>> candidates(shardSpecs.size());
+  std::vector<llvm::SmallVector<double>> prefixCost(shardSpecs.size());
+  std::vector<llvm::SmallVector<int>> prevCandidate(shardSpecs.size());
+
+  for (size_t i = 0; i < shardSpecs.size(); ++i) {
+    Operation *op = shardSpecs[i].op;
+    Operation *prevOp = i > 0 ? shardSpecs[i - 1].op : nullptr;
+
+    LayoutAttr tunedLayout =
+        tunedOnly ? getTunedLayout(op, shardSolver) : LayoutAttr();
+    if (tunedLayout) {
+      candidates[i].push_back(tunedLayout);
+    } else {
+      for (LayoutAttr layout : shardSolver.at(op)) {
+        candidates[i].push_back(layout);
+      }
+    }
+    prefixCost[i].assign(candidates[i].size(), kInfeasible);
+    prevCandidate[i].assign(candidates[i].size(), -1);
+
+    // Edges from the previous op in the chain are accounted in transitions,
+    // the rest of incoming edges only depend on the layout of this op.
+    //
+    llvm::SmallVector<Edge> chainEdges;
+    for (size_t operandIndex = 0; operandIndex < op->getNumOperands();
+         operandIndex++) {
+      if (prevOp && op->getOperand(operandIndex).getDefiningOp() == prevOp) {
+        chainEdges.push_back(Edge(prevOp, op, operandIndex));
+      }
+    }
+
+    for (size_t c = 0; c < candidates[i].size(); ++c) {
+      LayoutAttr layout = candidates[i][c];
+      double opCost = costModel->getOpCost(op, layout) +
+                      getIncomingReshardCost(op, layout, shardSolver,
+                                             noSelectedOpLayout, prevOp);
+      if (i == 0) {
+        prefixCost[i][c] = opCost;
+        continue;
+      }
+
+      for (size_t p = 0; p < candidates[i - 1].size(); ++p) {
+        if (prefixCost[i - 1][p] == kInfeasible) {
+          continue;
+        }
+
+        LayoutAttr prevLayout = candidates[i - 1][p];
+        double transitionCost = 0;
+        for (const Edge &edge : chainEdges) {
+          if (shardSolver.isResharded(edge)) {
+            transitionCost += costModel->getReshardCost(
+                mlir::cast<RankedTensorType>(
+                    op->getOperand(edge.operandIndex).getType()),
+                prevLayout, layout);
+          } else if (!shardSolver.isValidLayoutPair(edge, prevLayout,
+                                                    layout)) {
+            transitionCost = kInfeasible;
+            break;
+          }
+        }
+
+        double cost = prefixCost[i - 1][p] + transitionCost + opCost;
+        if (cost < prefixCost[i][c]) {
+          prefixCost[i][c] = cost;
+          prevCandidate[i][c] = p;
+        }
+      }
+    }
+  }
+
+  // Pick the cheapest candidate of the last op and walk back the chain. Ties
+  // keep the solver order.
+  //
+  int bestCandidate = -1;
+  for (size_t c = 0; c < candidates.back().size(); ++c) {
+    if (prefixCost.back()[c] != kInfeasible &&
+        (bestCandidate < 0 ||
+         prefixCost.back()[c] < prefixCost.back()[bestCandidate])) {
+      bestCandidate = c;
+    }
+  }
+
+  if (bestCandidate < 0) {
+    return false;
+  }
+
+  selectedLayouts.assign(shardSpecs.size(), LayoutAttr());
+  for (int i = shardSpecs.size() - 1; i >= 0; --i) {
+    selectedLayouts[i] = candidates[i][bestCandidate];
+    bestCandidate = prevCandidate[i][bestCandidate];
+  }
+
+  return true;
+}
+
+} // namespace mlir::tt::ttir
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/L1SpillAnalysis.h"
+#include "ttmlir/Dialect/TTIR/Analysis/L1Usage.h"
+#include "ttmlir/Dialect/TTIR/Analysis/MemoryScheduleAnalysis.h"
+
+namespace mlir::tt::ttir {
+
+bool L1SpillAnalysis::applyOverrides() {
+
+  // Placeholder, no overrides for now.
+  //
+  return false;
+}
+
+// L1 resident part of a tensor's life, from its producer or refill until its
+// last user or spill. Uses are schedule steps of its users, in order.
+//
+struct L1LiveRange {
+  Operation *op;
+  int64_t start;
+  int64_t end;
+  llvm::SmallVector<int64_t> uses;
+  uint64_t size;
+  bool spillable;
+};
+
+void L1SpillAnalysis::planFunc(ArrayRef<Operation *> schedule) {
+  llvm::DenseMap<Operation *, int64_t> schedulePos;
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    schedulePos[schedule[i]] = i;
+  }
+
+  std::vector<L1LiveRange> liveRanges;
+  std::vector<uint64_t> execL1Usage(schedule.size(), 0);
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    Operation *op = schedule[i];
+    if (op->getNumResults() == 0) {
+      continue;
+    }
+
+    RankedTensorType tensorType =
+        mlir::cast<RankedTensorType>(op->getResult(0).getType());
+    LayoutAttr layout = analysisInput.opLayouts.lookup(op);
+    if (!layout) {
+      layout = mlir::dyn_cast_or_null<LayoutAttr>(tensorType.getEncoding());
+    }
+
+    if (!layout) {
+      continue;
+    }
+
+    execL1Usage[i] = getOpL1ExecUsage(op, layout);
+    if (layout.getMemorySpace() != MemorySpace::DeviceL1) {
+      continue;
+    }
+
+    L1LiveRange liveRange{op,
+                          static_cast<int64_t>(i),
+                          static_cast<int64_t>(i),
+                          {},
+                          analysisInput.layoutSizeCache->getLayoutSizeBytes(
+                              getCurrentScopeDevice(op), tensorType.getShape(),
+                              layout, MemorySpace::DeviceL1),
+                          !analysisInput.fixedOps.contains(op)};
+    for (Operation *user : op->getResult(0).getUsers()) {
+      auto userPos = schedulePos.find(user);
+      if (userPos == schedulePos.end()) {
+        liveRange.end = schedule.size();
+        liveRange.spillable = false;
+        continue;
+      }
+
+      liveRange.uses.push_back(userPos->second);
+      liveRange.end = std::max(liveRange.end, userPos->second);
+      if (analysisInput.fixedOps.contains(user)) {
+        liveRange.spillable = false;
+      }
+    }
+
+    llvm::sort(liveRange.uses);
+    liveRange.uses.erase(
+        std::unique(liveRange.uses.begin(), liveRange.uses.end()),
+        liveRange.uses.end());
+    liveRanges.push_back(std::move(liveRange));
+  }
+
+  for (int64_t step = 0; step < static_cast<int64_t>(schedule.size());
+       ++step) {
+    auto isLive = [step](const L1LiveRange &liveRange) {
+      return liveRange.start <= step && step <= liveRange.end;
+    };
+
+    uint64_t l1Usage = execL1Usage[step];
+    for (const L1LiveRange &liveRange : liveRanges) {
+      if (isLive(liveRange)) {
+        l1Usage += liveRange.size;
+      }
+    }
+
+    while (l1Usage >= analysisInput.usableL1CacheSize) {
+      // Belady's choice weighted by size, evict the tensor which frees the
+      // most L1 for the longest time.
+      //
+      std::optional<size_t> victim;
+      uint64_t victimScore = 0;
+      for (size_t i = 0; i < liveRanges.size(); ++i) {
+        const L1LiveRange &liveRange = liveRanges[i];
+        if (!liveRange.spillable || !isLive(liveRange) ||
+            liveRange.start == step) {
+          continue;
+        }
+
+        auto nextUse = llvm::lower_bound(liveRange.uses, step);
+        if (nextUse == liveRange.uses.end() || *nextUse == step) {
+          continue;
+        }
+
+        uint64_t score = (*nextUse - step) * liveRange.size;
+        if (!victim || score > victimScore) {
+          victim = i;
+          victimScore = score;
+        }
+      }
+
+      if (!victim) {
+        analysisResult.overSubscribedOps.push_back(schedule[step]);
+        break;
+      }
+
+      // Tensor leaves L1 after its last user before the step, or right after
+      // it is produced, and is refilled right before its next user.
+      //
+      L1LiveRange &liveRange = liveRanges[*victim];
+      auto nextUse = llvm::lower_bound(liveRange.uses, step);
+      int64_t spillPos =
+          nextUse == liveRange.uses.begin() ? liveRange.start : *(nextUse - 1);
+      analysisResult.spills.push_back(
+          L1Spill{liveRange.op, schedule[spillPos], schedule[*nextUse]});
+
+      L1LiveRange refilledLiveRange = liveRange;
+      refilledLiveRange.start = *nextUse;
+      refilledLiveRange.uses.assign(nextUse, liveRange.uses.end());
+      liveRange.end = spillPos;
+      liveRange.uses.erase(nextUse, liveRange.uses.end());
+      l1Usage -= liveRange.size;
+      liveRanges.push_back(std::move(refilledLiveRange));
+    }
+  }
+}
+
+void L1SpillAnalysis::analysisImplementation() {
+  op->walk([&](func::FuncOp func) {
+    llvm::SmallVector<Operation *> schedule =
+        analysisInput.schedule.lookup(func);
+    if (schedule.empty()) {
+      schedule = getProgramOrderSchedule(func);
+    }
+
+    planFunc(schedule);
+  });
+}
+} // namespace mlir::tt::ttir
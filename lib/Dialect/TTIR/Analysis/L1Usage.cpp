@@ -0,0 +1,20 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/L1Usage.h"
+#include "ttmlir/Dialect/TTIR/IR/TTIROps.h"
+
+namespace mlir::tt::ttir {
+
+uint64_t getOpL1ExecUsage(Operation *op, LayoutAttr outputLayout) {
+  TTIROp ttirOp = llvm::dyn_cast<TTIROp>(op);
+  if (!ttirOp) {
+    return 0;
+  }
+
+  return ttirOp.getOpL1ScratchUsage(outputLayout) +
+         ttirOp.getOpL1ProgramUsage();
+}
+
+} // namespace mlir::tt::ttir
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutOverrideMatcher.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/Location.h"
+
+namespace mlir::tt::ttir {
+
+bool LayoutOverrideMatcher::isGlob(StringRef key) {
+  return key.find_first_of("*?[{\\") != StringRef::npos;
+}
+
+llvm::Expected<LayoutOverrideMatcher::OpTypeOverride>
+LayoutOverrideMatcher::parseOpTypeKey(StringRef key, StringRef &opType) {
+  StringRef shapeKey;
+  std::tie(opType, shapeKey) = key.drop_front().split('<');
+  if (opType.empty()) {
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "Missing op type in override: " + key);
+  }
+
+  OpTypeOverride opTypeOverride{std::nullopt, nullptr};
+  if (shapeKey.empty() && !key.contains('<')) {
+    return opTypeOverride;
+  }
+
+  if (!shapeKey.consume_back(">") || shapeKey.empty()) {
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "Invalid shape in override: " + key);
+  }
+
+  SmallVector<StringRef> dims;
+  shapeKey.split(dims, 'x');
+  opTypeOverride.shape.emplace();
+  for (StringRef dim : dims) {
+    int64_t dimSize;
+    if (dim == "*") {
+      dimSize = ShapedType::kDynamic;
+    } else if (dim.getAsInteger(10 /*Radix*/, dimSize) || dimSize < 0) {
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "Invalid dim size in override: " + key);
+    }
+    opTypeOverride.shape->push_back(dimSize);
+  }
+
+  return opTypeOverride;
+}
+
+llvm::Error LayoutOverrideMatcher::verifyKey(StringRef key) {
+  if (key.starts_with("@")) {
+    StringRef opType;
+    return parseOpTypeKey(key, opType).takeError();
+  }
+
+  if (isGlob(key)) {
+    return llvm::GlobPattern::create(key).takeError();
+  }
+
+  return llvm::Error::success();
+}
+
+llvm::Expected<LayoutOverrideMatcher> LayoutOverrideMatcher::create(
+    const llvm::StringMap<LayoutOverrideParams> &overrides) {
+  LayoutOverrideMatcher matcher;
+
+  // Keys are visited in order, so that the winner among several matching op
+  // type overrides or globs doesn't depend on hash order of the map.
+  //
+  SmallVector<StringRef> keys;
+  for (const auto &entry : overrides) {
+    keys.push_back(entry.getKey());
+  }
+  llvm::sort(keys);
+
+  for (StringRef key : keys) {
+    const LayoutOverrideParams *params = &overrides.find(key)->getValue();
+    if (key.starts_with("@")) {
+      StringRef opType;
+      llvm::Expected<OpTypeOverride> opTypeOverride =
+          parseOpTypeKey(key, opType);
+      if (!opTypeOverride) {
+        return opTypeOverride.takeError();
+      }
+
+      opTypeOverride->params = params;
+      matcher.opTypeOverrides[opType].push_back(std::move(*opTypeOverride));
+    } else if (isGlob(key)) {
+      llvm::Expected<llvm::GlobPattern> pattern =
+          llvm::GlobPattern::create(key);
+      if (!pattern) {
+        return pattern.takeError();
+      }
+
+      matcher.globOverrides.push_back(
+          GlobOverride{std::move(*pattern), params});
+    } else {
+      matcher.nameOverrides[key] = params;
+    }
+  }
+
+  // Overrides with shape are more specific than overrides of any shape.
+  //
+  for (auto &entry : matcher.opTypeOverrides) {
+    std::stable_partition(
+        entry.getValue().begin(), entry.getValue().end(),
+        [](const OpTypeOverride &override) {
+          return override.shape.has_value();
+        });
+  }
+
+  return matcher;
+}
+
+static bool matchesShape(ArrayRef<int64_t> shape, ArrayRef<int64_t> pattern) {
+  if (shape.size() != pattern.size()) {
+    return false;
+  }
+
+  for (auto [dimSize, patternDimSize] : llvm::zip(shape, pattern)) {
+    if (patternDimSize != ShapedType::kDynamic && patternDimSize != dimSize) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+const LayoutOverrideParams *
+LayoutOverrideMatcher::lookup(Operation *op) const {
+  if (op->getNumResults() == 0) {
+    return nullptr;
+  }
+
+  std::optional<StringRef> opLocName;
+  if (NameLoc nameLoc = mlir::dyn_cast<NameLoc>(op->getLoc())) {
+    opLocName = nameLoc.getName().strref();
+    auto nameOverride = nameOverrides.find(*opLocName);
+    if (nameOverride != nameOverrides.end()) {
+      return nameOverride->getValue();
+    }
+  }
+
+  auto opTypeOverride = opTypeOverrides.find(op->getName().getStringRef());
+  if (opTypeOverride != opTypeOverrides.end()) {
+    RankedTensorType tensorType =
+        mlir::cast<RankedTensorType>(op->getResult(0).getType());
+    for (const OpTypeOverride &override : opTypeOverride->getValue()) {
+      if (!override.shape ||
+          matchesShape(tensorType.getShape(), *override.shape)) {
+        return override.params;
+      }
+    }
+  }
+
+  if (opLocName) {
+    for (const GlobOverride &override : globOverrides) {
+      if (override.pattern.match(*opLocName)) {
+        return override.params;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+} // namespace mlir::tt::ttir
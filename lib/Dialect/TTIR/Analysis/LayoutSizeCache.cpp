@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
+
+namespace mlir::tt::ttir {
+
+uint64_t LayoutSizeCache::getLayoutSizeBytes(DeviceAttr device,
+                                             ArrayRef<int64_t> tensorShape,
+                                             LayoutAttr layout,
+                                             MemorySpace memorySpace) {
+  LayoutSizeKey key(device, layout, memorySpace, tensorShape);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto match = cache.find(key);
+    if (match != cache.end()) {
+      numHits++;
+      return match->second;
+    }
+    numMisses++;
+  }
+
+  // Compute outside of the lock, concurrent misses on the same key produce
+  // the same value.
+  //
+  uint64_t sizeBytes =
+      device.getLayoutSizeBytes(tensorShape, layout, memorySpace);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  cache.emplace(std::move(key), sizeBytes);
+  return sizeBytes;
+}
+
+uint64_t LayoutSizeCache::getNumHits() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return numHits;
+}
+
+uint64_t LayoutSizeCache::getNumMisses() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return numMisses;
+}
+
+} // namespace mlir::tt::ttir
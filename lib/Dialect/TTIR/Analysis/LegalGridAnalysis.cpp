@@ -13,18 +13,18 @@ bool mock_is_output_tensor_legal_for_op(Operation *op, LayoutAttr layout) {
   return true;
 }
 
-bool tensor_shape_compatible_with_shard(Operation *op, LayoutAttr layout) {
-  // These constraints are implemented seperatelly in every TTNN op.
-  // Almost nothing seems to be shared between EVERY op, so is hard to have any
-  // logic here without the risk of discarding a valid configuraiton or modeling
-  // the constraint for each op. This logic may be offloaded to the TTNN op
-  // interface.
-
-  // For now we will check if the tilised tensor dims are divisible by the grid
-  // dims. This will definitly discard possible valid configurations, but is a
-  // start.
-  RankedTensorType tensorType =
-      mlir::cast<RankedTensorType>(op->getResult(0).getType());
+// Number of tiles along the two innermost dims of the tensor.
+//
+// Shard constraints are implemented seperatelly in every TTNN op. Almost
+// nothing seems to be shared between EVERY op, so is hard to have any logic
+// here without the risk of discarding a valid configuraiton or modeling the
+// constraint for each op. This logic may be offloaded to the TTNN op
+// interface.
+//
+// For now grid dims are picked so that every core holds a shard of whole
+// tiles, the last row or column of cores possibly a partial one. This will
+// definitly discard possible valid configurations, but is a start.
+static std::pair<int64_t, int64_t> getTileCounts(RankedTensorType tensorType) {
   llvm::ArrayRef<int64_t> tensorShape = tensorType.getShape();
 
   int64_t MTiles = 1;
@@ -34,10 +34,96 @@ bool tensor_shape_compatible_with_shard(Operation *op, LayoutAttr layout) {
 
   int64_t KTIles = (tensorShape.back() + 31) / 32;
 
-  int64_t gridR = layout.getGrid().getShape()[0];
-  int64_t gridC = layout.getGrid().getShape()[1];
+  return {MTiles, KTIles};
+}
+
+// Grid dims in [minDim, maxDim] to shard n tiles over. Shards are uneven
+// if the dim doesn't divide n, with the last core holding a partial shard.
+// Only the smallest dim for every shard size is kept, larger ones would leave
+// cores without any tiles. Increasing order.
+static std::vector<int64_t> getShardGridDims(int64_t n, int64_t minDim,
+                                             int64_t maxDim) {
+  std::vector<int64_t> gridDims;
+  for (int64_t dim = minDim; dim <= std::min(n, maxDim); ++dim) {
+    int64_t shardSize = llvm::divideCeil(n, dim);
+    if (llvm::divideCeil(n, shardSize) == dim) {
+      gridDims.push_back(dim);
+    }
+  }
+  return gridDims;
+}
+
+// Reshard compatibility class of a layout, layouts of different classes
+// never replace each other when pruning.
+//
+// The class is the memory layout: a neighbour consumes a height, width or
+// block sharded tensor as such, so a layout never stands in for one of
+// another memory layout. Grids are not part of the class. Cost and L1 usage
+// depend only on the output shape and layout, so neighbours with the same
+// output shape keep the same frontier and can still share a layout without a
+// reshard, neighbours with another shape never share one.
+//
+static TensorMemoryLayout getCompatibilityClass(LayoutAttr layout) {
+  return layout.getMemLayout();
+}
+
+// Keeps the Pareto frontier over (estimated cost, L1 bytes per core) within
+// each reshard compatibility class. Dropped layouts are no cheaper than, and
+// take no less L1 than, a kept layout of the same class. Order of kept layouts
+// is preserved.
+//
+std::vector<LayoutAttr>
+paretoFrontier(Operation *op, const std::vector<LayoutAttr> &layouts,
+               OpCostModel *costModel, LayoutSizeCache *layoutSizeCache) {
+  struct Candidate {
+    LayoutAttr layout;
+    double cost;
+    uint64_t l1Usage;
+  };
+
+  DeviceAttr deviceAttr = getCurrentScopeDevice(op);
+  llvm::ArrayRef<int64_t> tensorShape =
+      mlir::cast<RankedTensorType>(op->getResult(0).getType()).getShape();
+  std::vector<Candidate> candidates;
+  candidates.reserve(layouts.size());
+  for (LayoutAttr layout : layouts) {
+    candidates.push_back(
+        {layout, costModel->getOpCost(op, layout),
+         layoutSizeCache->getLayoutSizeBytes(deviceAttr, tensorShape, layout,
+                                             layout.getMemorySpace())});
+  }
+
+  // Sweep each class by increasing L1 usage, a candidate is kept only if it is
+  // cheaper than every candidate of its class using less L1.
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate &a, const Candidate &b) {
+                     if (getCompatibilityClass(a.layout) !=
+                         getCompatibilityClass(b.layout)) {
+                       return getCompatibilityClass(a.layout) <
+                              getCompatibilityClass(b.layout);
+                     }
+                     if (a.l1Usage != b.l1Usage) {
+                       return a.l1Usage < b.l1Usage;
+                     }
+                     return a.cost < b.cost;
+                   });
 
-  return (MTiles % gridR == 0) && (KTIles % gridC == 0);
+  llvm::DenseSet<LayoutAttr> frontier;
+  double bestCost = 0;
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    bool newClass =
+        i == 0 || getCompatibilityClass(candidates[i].layout) !=
+                      getCompatibilityClass(candidates[i - 1].layout);
+    if (newClass || candidates[i].cost < bestCost) {
+      frontier.insert(candidates[i].layout);
+      bestCost = candidates[i].cost;
+    }
+  }
+
+  std::vector<LayoutAttr> result;
+  llvm::copy_if(layouts, std::back_inserter(result),
+                [&](LayoutAttr layout) { return frontier.contains(layout); });
+  return result;
 }
 
 bool cantChangeOutputLayout(Operation *op) {
@@ -52,26 +138,22 @@ bool cantChangeOutputLayout(Operation *op) {
 }
 
 bool LegalGridAnalysis::applyOverrides() {
-  // Lookup layout overrides based on location information for current
-  // operation.
+  // Lookup layout overrides based on location information, op type and
+  // output shape of current operation.
   //
 
   if (not analysisInput.outputLayoutOverrides) {
     return false;
   }
 
-  if (not isa<NameLoc>(op->getLoc())) {
-    return false;
-  }
-
-  StringRef opLocName = mlir::cast<NameLoc>(op->getLoc()).getName();
-  auto gridOverride = analysisInput.outputLayoutOverrides->find(opLocName);
+  const LayoutOverrideParams *gridOverride =
+      analysisInput.outputLayoutOverrides->lookup(op);
 
-  if (gridOverride == analysisInput.outputLayoutOverrides->end()) {
+  if (not gridOverride) {
     return false;
   }
 
-  LayoutOverrideParams override = gridOverride->getValue();
+  LayoutOverrideParams override = *gridOverride;
   RankedTensorType tensorType =
       mlir::cast<RankedTensorType>(op->getResult(0).getType());
   LayoutAttr layout = mlir::cast<LayoutAttr>(tensorType.getEncoding());
@@ -87,6 +169,32 @@ bool LegalGridAnalysis::applyOverrides() {
 }
 
 void LegalGridAnalysis::analysisImplementation() {
+  // Skip operations that don't have output tensors.
+  if (op->getNumResults() == 0) {
+    return;
+  }
+
+  // Structurally identical ops share legal layouts. Overridden ops never get
+  // here, so overrides are not cached.
+  if (not analysisInput.legalLayoutCache) {
+    generateLegalLayouts();
+    return;
+  }
+
+  LegalLayoutKey key(op->getName(),
+                     mlir::cast<RankedTensorType>(op->getResult(0).getType()),
+                     analysisInput.maxGrid, analysisInput.maxShardedGrids);
+  if (const std::vector<LayoutAttr> *legalLayouts =
+          analysisInput.legalLayoutCache->lookup(key)) {
+    analysisResult = *legalLayouts;
+    return;
+  }
+
+  generateLegalLayouts();
+  analysisInput.legalLayoutCache->insert(key, analysisResult);
+}
+
+void LegalGridAnalysis::generateLegalLayouts() {
   // A first incomplete implementation of the LegalGridAnalysis.
   // This implementation is a placeholder and is meant to just enable testing of
   // other components.
@@ -137,16 +245,22 @@ void LegalGridAnalysis::analysisImplementation() {
       layout.withMemorySpace(op->getContext(), MemorySpace::DeviceL1);
   std::vector<LayoutAttr> shardedResults;
 
+  // Only grids which leave no core without tiles are generated, every core
+  // holds a shard of whole tiles.
+  auto [MTiles, KTiles] = getTileCounts(tensorType);
+
   // Block Sharded
-  for (auto width = 1; width <= analysisInput.maxGrid.getShape()[0]; ++width) {
-    for (auto height = 1; height <= analysisInput.maxGrid.getShape()[1];
-         ++height) {
+  for (int64_t width :
+       getShardGridDims(MTiles, 1, analysisInput.maxGrid.getShape()[0])) {
+    for (int64_t height :
+         getShardGridDims(KTiles, 1, analysisInput.maxGrid.getShape()[1])) {
       shardedResults.push_back(
           shardedBase
               .withGrid(op->getContext(), tensorType,
                         GridAttr::get(op->getContext(), {width, height}))
               .withMemoryLayout(op->getContext(),
-                                TensorMemoryLayout::BlockSharded));
+                                TensorMemoryLayout::BlockSharded)
+              .withTileAlignedShardShape(op->getContext()));
     }
   }
 
@@ -155,40 +269,73 @@ void LegalGridAnalysis::analysisImplementation() {
   // Height Sharded
   // TODO(odjuricic): Missing affine mapping to actual grid. Need to check with
   // runtime implementation on what to produce here.
-  for (auto height = 2; height <= numCores; ++height) {
+  for (int64_t height : getShardGridDims(MTiles, 2, numCores)) {
     shardedResults.push_back(
         shardedBase
             .withGrid(op->getContext(), tensorType,
                       GridAttr::get(op->getContext(), {height, 1}))
             .withMemoryLayout(op->getContext(),
-                              TensorMemoryLayout::HeightSharded));
+                              TensorMemoryLayout::HeightSharded)
+            .withTileAlignedShardShape(op->getContext()));
   }
 
   // Width Sharded
-  for (auto width = 2; width <= numCores; ++width) {
+  for (int64_t width : getShardGridDims(KTiles, 2, numCores)) {
     shardedResults.push_back(
         shardedBase
             .withGrid(op->getContext(), tensorType,
                       GridAttr::get(op->getContext(), {1, width}))
             .withMemoryLayout(op->getContext(),
-                              TensorMemoryLayout::WidthSharded));
+                              TensorMemoryLayout::WidthSharded)
+            .withTileAlignedShardShape(op->getContext()));
   }
 
   // Filter layouts based on output tensor legality for current op.
   shardedResults.erase(
       std::remove_if(shardedResults.begin(), shardedResults.end(),
                      [this](LayoutAttr layout) {
-                       return !tensor_shape_compatible_with_shard(op, layout) ||
-                              !mock_is_output_tensor_legal_for_op(op, layout);
+                       return !mock_is_output_tensor_legal_for_op(op, layout);
                      }),
       shardedResults.end());
 
-  // Pick top largest sharded grids.
-  std::sort(shardedResults.begin(), shardedResults.end(),
-            [](LayoutAttr a, LayoutAttr b) {
-              return a.getGrid().getShape()[0] * a.getGrid().getShape()[1] >
-                     b.getGrid().getShape()[0] * b.getGrid().getShape()[1];
-            });
+  // Filter out layouts whose output shard alone does not fit into L1.
+  assert(analysisInput.layoutSizeCache);
+  DeviceAttr deviceAttr = getCurrentScopeDevice(op);
+  uint64_t usableL1Size = analysisInput.chipDesc.getUsableL1Size();
+  shardedResults.erase(
+      std::remove_if(shardedResults.begin(), shardedResults.end(),
+                     [&](LayoutAttr layout) {
+                       return analysisInput.layoutSizeCache->getLayoutSizeBytes(
+                                  deviceAttr, tensorType.getShape(), layout,
+                                  layout.getMemorySpace()) > usableL1Size;
+                     }),
+      shardedResults.end());
+
+  // Drop layouts dominated in both cost and L1 usage before capping the
+  // number of layouts, so the cap does not cut off the cheap or small ones.
+  if (analysisInput.costModel) {
+    shardedResults =
+        paretoFrontier(op, shardedResults, analysisInput.costModel,
+                       analysisInput.layoutSizeCache);
+  }
+
+  // Pick top cheapest sharded grids, largest grids first among equally cheap
+  // ones or if there is no cost model.
+  llvm::DenseMap<LayoutAttr, double> costs;
+  if (analysisInput.costModel) {
+    for (LayoutAttr layout : shardedResults) {
+      costs[layout] = analysisInput.costModel->getOpCost(op, layout);
+    }
+  }
+  std::stable_sort(
+      shardedResults.begin(), shardedResults.end(),
+      [&](LayoutAttr a, LayoutAttr b) {
+        if (costs.lookup(a) != costs.lookup(b)) {
+          return costs.lookup(a) < costs.lookup(b);
+        }
+        return a.getGrid().getShape()[0] * a.getGrid().getShape()[1] >
+               b.getGrid().getShape()[0] * b.getGrid().getShape()[1];
+      });
 
   analysisResult.insert(
       analysisResult.end(), shardedResults.begin(),
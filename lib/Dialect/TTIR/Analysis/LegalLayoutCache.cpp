@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/LegalLayoutCache.h"
+#include "mlir/AsmParser/AsmParser.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir::tt::ttir {
+
+template <typename T> static std::string printToString(T value) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  value.print(os);
+  return os.str();
+}
+
+llvm::SmallString<32>
+LegalLayoutCache::getFingerprint(SystemDescAttr systemDesc, DeviceAttr device) {
+  llvm::MD5 hasher;
+  hasher.update(std::to_string(kVersion));
+  hasher.update(printToString(systemDesc));
+  hasher.update(printToString(device));
+  llvm::MD5::MD5Result result;
+  hasher.final(result);
+  return result.digest();
+}
+
+const std::vector<LayoutAttr> *
+LegalLayoutCache::lookup(const LegalLayoutKey &key) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto match = cache.find(key);
+  if (match == cache.end()) {
+    numMisses++;
+    return nullptr;
+  }
+
+  numHits++;
+  return &match->second;
+}
+
+void LegalLayoutCache::insert(const LegalLayoutKey &key,
+                              const std::vector<LayoutAttr> &legalLayouts) {
+  std::lock_guard<std::mutex> lock(mutex);
+  cache.emplace(key, legalLayouts);
+}
+
+// File format:
+// {
+//   "fingerprint": "<md5 of system desc and device>",
+//   "entries": [{"op": "ttir.add", "type": "tensor<...>", "max_grid": [8, 8],
+//                "max_sharded_grids": 64, "layouts": ["#tt.layout<...>"]}]
+// }
+//
+LogicalResult LegalLayoutCache::load(MLIRContext *context, StringRef path) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
+      llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return failure();
+  }
+
+  llvm::Expected<llvm::json::Value> json =
+      llvm::json::parse((*buffer)->getBuffer());
+  if (!json) {
+    llvm::consumeError(json.takeError());
+    return failure();
+  }
+
+  const llvm::json::Object *root = json->getAsObject();
+  if (!root) {
+    return failure();
+  }
+
+  std::optional<StringRef> fileFingerprint = root->getString("fingerprint");
+  if (!fileFingerprint || *fileFingerprint != fingerprint) {
+    return success();
+  }
+
+  const llvm::json::Array *entries = root->getArray("entries");
+  if (!entries) {
+    return failure();
+  }
+
+  // Entries are added only once the whole file is parsed, a broken file
+  // leaves the cache as it was.
+  std::unordered_map<LegalLayoutKey, std::vector<LayoutAttr>> loaded;
+  for (const llvm::json::Value &entryValue : *entries) {
+    const llvm::json::Object *entry = entryValue.getAsObject();
+    if (!entry) {
+      return failure();
+    }
+
+    std::optional<StringRef> opName = entry->getString("op");
+    std::optional<StringRef> type = entry->getString("type");
+    const llvm::json::Array *maxGridShape = entry->getArray("max_grid");
+    std::optional<int64_t> maxShardedGrids =
+        entry->getInteger("max_sharded_grids");
+    const llvm::json::Array *layouts = entry->getArray("layouts");
+    if (!opName || !type || !maxGridShape || !maxShardedGrids || !layouts) {
+      return failure();
+    }
+
+    RankedTensorType tensorType =
+        mlir::dyn_cast_or_null<RankedTensorType>(parseType(*type, context));
+    if (!tensorType) {
+      return failure();
+    }
+
+    llvm::SmallVector<int64_t> gridShape;
+    for (const llvm::json::Value &dim : *maxGridShape) {
+      std::optional<int64_t> dimSize = dim.getAsInteger();
+      if (!dimSize) {
+        return failure();
+      }
+      gridShape.push_back(*dimSize);
+    }
+
+    std::vector<LayoutAttr> legalLayouts;
+    for (const llvm::json::Value &layoutValue : *layouts) {
+      std::optional<StringRef> layoutStr = layoutValue.getAsString();
+      LayoutAttr layout =
+          layoutStr ? mlir::dyn_cast_or_null<LayoutAttr>(
+                          parseAttribute(*layoutStr, context))
+                    : LayoutAttr();
+      if (!layout) {
+        return failure();
+      }
+      legalLayouts.push_back(layout);
+    }
+
+    LegalLayoutKey key(OperationName(*opName, context), tensorType,
+                       GridAttr::get(context, gridShape), *maxShardedGrids);
+    loaded.emplace(key, std::move(legalLayouts));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto &keyLayouts : loaded) {
+    cache.emplace(keyLayouts.first, std::move(keyLayouts.second));
+  }
+  return success();
+}
+
+LogicalResult LegalLayoutCache::save(StringRef path) const {
+  // Entries are sorted by their printed key, hash map order would change the
+  // file between compilations.
+  std::vector<std::pair<std::string, llvm::json::Object>> sortedEntries;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto &keyLayouts : cache) {
+      const LegalLayoutKey &key = keyLayouts.first;
+      llvm::json::Array layouts;
+      for (LayoutAttr layout : keyLayouts.second) {
+        layouts.push_back(printToString(layout));
+      }
+
+      std::string type = printToString(key.tensorType);
+      std::string sortKey = llvm::formatv(
+          "{0} {1} {2:$[x]} {3}", key.opName.getStringRef(), type,
+          llvm::make_range(key.maxGrid.getShape().begin(),
+                           key.maxGrid.getShape().end()),
+          key.maxShardedGrids);
+      sortedEntries.emplace_back(
+          std::move(sortKey),
+          llvm::json::Object{
+              {"op", key.opName.getStringRef()},
+              {"type", std::move(type)},
+              {"max_grid", llvm::json::Array(key.maxGrid.getShape())},
+              {"max_sharded_grids", key.maxShardedGrids},
+              {"layouts", std::move(layouts)},
+          });
+    }
+  }
+
+  llvm::sort(sortedEntries, [](const auto &a, const auto &b) {
+    return a.first < b.first;
+  });
+  llvm::json::Array entries;
+  for (auto &sortKeyEntry : sortedEntries) {
+    entries.push_back(std::move(sortKeyEntry.second));
+  }
+
+  std::error_code ec;
+  llvm::raw_fd_ostream os(path, ec);
+  if (ec) {
+    return failure();
+  }
+
+  os << llvm::formatv(
+      "{0:2}", llvm::json::Value(llvm::json::Object{
+                   {"fingerprint", fingerprint.str()},
+                   {"entries", std::move(entries)},
+               }));
+  return success();
+}
+
+uint64_t LegalLayoutCache::getNumHits() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return numHits;
+}
+
+uint64_t LegalLayoutCache::getNumMisses() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return numMisses;
+}
+
+} // namespace mlir::tt::ttir
@@ -0,0 +1,214 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/MemoryScheduleAnalysis.h"
+#include "ttmlir/Scheduler/Scheduler.h"
+
+#include <limits>
+
+namespace mlir::tt::ttir {
+
+static uint64_t
+getOutputMemoryUsage(Operation *op,
+                     const llvm::DenseMap<Operation *, LayoutAttr> &opLayouts,
+                     MemorySpace memorySpace,
+                     LayoutSizeCache *layoutSizeCache) {
+  RankedTensorType tensorType =
+      mlir::cast<RankedTensorType>(op->getResult(0).getType());
+  LayoutAttr layout = opLayouts.lookup(op);
+  if (!layout) {
+    layout = mlir::dyn_cast_or_null<LayoutAttr>(tensorType.getEncoding());
+  }
+
+  if (!layout || layout.getMemorySpace() != memorySpace) {
+    return 0;
+  }
+
+  return layoutSizeCache->getLayoutSizeBytes(getCurrentScopeDevice(op),
+                                             tensorType.getShape(), layout,
+                                             memorySpace);
+}
+
+std::vector<uint64_t>
+getScheduleMemoryUsage(ArrayRef<Operation *> schedule,
+                       const llvm::DenseMap<Operation *, LayoutAttr> &opLayouts,
+                       MemorySpace memorySpace,
+                       LayoutSizeCache *layoutSizeCache) {
+  llvm::DenseMap<Operation *, int64_t> schedulePos;
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    schedulePos[schedule[i]] = i;
+  }
+
+  // Tensors freed after each step of the schedule.
+  //
+  std::vector<uint64_t> freedAfter(schedule.size(), 0);
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    Operation *op = schedule[i];
+    int64_t lastUse = i;
+    for (Operation *user : op->getResult(0).getUsers()) {
+      auto userPos = schedulePos.find(user);
+      if (userPos == schedulePos.end()) {
+        lastUse = -1;
+        break;
+      }
+      lastUse = std::max(lastUse, userPos->second);
+    }
+
+    if (lastUse >= 0) {
+      freedAfter[lastUse] +=
+          getOutputMemoryUsage(op, opLayouts, memorySpace, layoutSizeCache);
+    }
+  }
+
+  uint64_t liveUsage = 0;
+  std::vector<uint64_t> usage(schedule.size(), 0);
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    liveUsage += getOutputMemoryUsage(schedule[i], opLayouts, memorySpace,
+                                      layoutSizeCache);
+    usage[i] = liveUsage;
+    liveUsage -= freedAfter[i];
+  }
+
+  return usage;
+}
+
+uint64_t getSchedulePeakMemoryUsage(
+    ArrayRef<Operation *> schedule,
+    const llvm::DenseMap<Operation *, LayoutAttr> &opLayouts,
+    MemorySpace memorySpace, LayoutSizeCache *layoutSizeCache) {
+  std::vector<uint64_t> usage = getScheduleMemoryUsage(
+      schedule, opLayouts, memorySpace, layoutSizeCache);
+  return usage.empty() ? 0 : *llvm::max_element(usage);
+}
+
+llvm::SmallVector<Operation *> getProgramOrderSchedule(func::FuncOp func) {
+  mlir::tt::scheduler::Scheduler scheduler(&func);
+  while (scheduler.hasUnscheduledOps()) {
+    scheduler.scheduleOp(scheduler.getNextScheduleableOp(
+        [](Operation *) -> int64_t { return 0; }));
+  }
+
+  return scheduler.getSchedule();
+}
+
+bool MemoryScheduleAnalysis::applyOverrides() {
+
+  // Placeholder, no overrides for now.
+  //
+  return false;
+}
+
+llvm::SmallVector<Operation *>
+MemoryScheduleAnalysis::scheduleFunc(func::FuncOp func) {
+  mlir::tt::scheduler::Scheduler scheduler(&func);
+
+  // Count uses left for every scheduled op. Tensors used outside of the
+  // scheduled ops are never freed.
+  //
+  llvm::DenseMap<Operation *, int64_t> usesLeft;
+  llvm::DenseSet<Operation *> usedOutside;
+  llvm::DenseMap<Operation *, uint64_t> l1Usage;
+  for (Operation *op : getProgramOrderSchedule(func)) {
+    usesLeft[op] = 0;
+  }
+
+  for (auto &opUses : usesLeft) {
+    Operation *op = opUses.first;
+    l1Usage[op] =
+        getOutputMemoryUsage(op, analysisInput.opLayouts, MemorySpace::DeviceL1,
+                             analysisInput.layoutSizeCache);
+    for (Operation *user : op->getResult(0).getUsers()) {
+      if (usesLeft.count(user)) {
+        opUses.second++;
+      } else {
+        usedOutside.insert(op);
+      }
+    }
+  }
+
+  // L1 freed once op is scheduled, tensors for which op is the last user.
+  //
+  auto getFreedL1Usage = [&](Operation *op) {
+    uint64_t freedL1Usage = 0;
+    llvm::SmallPtrSet<Operation *, 4> producers;
+    for (Value operand : op->getOperands()) {
+      Operation *producer = operand.getDefiningOp();
+      if (!producer || !usesLeft.count(producer) ||
+          usedOutside.contains(producer) ||
+          !producers.insert(producer).second) {
+        continue;
+      }
+
+      int64_t uses = llvm::count(op->getOperands(), producer->getResult(0));
+      if (usesLeft.lookup(producer) == uses) {
+        freedL1Usage += l1Usage.lookup(producer);
+      }
+    }
+
+    return freedL1Usage;
+  };
+
+  uint64_t liveL1Usage = 0;
+  auto priority = [&](Operation *op) -> int64_t {
+    int64_t outputL1Usage = l1Usage.lookup(op);
+    int64_t delta =
+        outputL1Usage - static_cast<int64_t>(getFreedL1Usage(op));
+    if (liveL1Usage + outputL1Usage > analysisInput.usableL1CacheSize) {
+      return std::numeric_limits<int64_t>::min() / 2 - delta;
+    }
+
+    return -delta;
+  };
+
+  while (scheduler.hasUnscheduledOps()) {
+    Operation *op = scheduler.getNextScheduleableOp(priority);
+    liveL1Usage += l1Usage.lookup(op);
+    liveL1Usage -= getFreedL1Usage(op);
+    for (Value operand : op->getOperands()) {
+      Operation *producer = operand.getDefiningOp();
+      if (producer && usesLeft.count(producer)) {
+        usesLeft[producer]--;
+      }
+    }
+
+    if (op->getResult(0).use_empty()) {
+      liveL1Usage -= l1Usage.lookup(op);
+    }
+
+    scheduler.scheduleOp(op);
+  }
+
+  return scheduler.getSchedule();
+}
+
+void MemoryScheduleAnalysis::analysisImplementation() {
+  op->walk([&](func::FuncOp func) {
+    llvm::SmallVector<Operation *> inputSchedule =
+        analysisInput.schedule.lookup(func);
+    if (inputSchedule.empty()) {
+      inputSchedule = getProgramOrderSchedule(func);
+    }
+
+    llvm::SmallVector<Operation *> memorySchedule = scheduleFunc(func);
+    uint64_t peakBefore = getSchedulePeakMemoryUsage(
+        inputSchedule, analysisInput.opLayouts, MemorySpace::DeviceL1,
+        analysisInput.layoutSizeCache);
+    uint64_t peakAfter = getSchedulePeakMemoryUsage(
+        memorySchedule, analysisInput.opLayouts, MemorySpace::DeviceL1,
+        analysisInput.layoutSizeCache);
+
+    if (peakAfter < peakBefore) {
+      analysisResult.schedule[func] = memorySchedule;
+    } else {
+      analysisResult.schedule[func] = inputSchedule;
+      peakAfter = peakBefore;
+    }
+
+    analysisResult.peakL1UsageBefore =
+        std::max(analysisResult.peakL1UsageBefore, peakBefore);
+    analysisResult.peakL1UsageAfter =
+        std::max(analysisResult.peakL1UsageAfter, peakAfter);
+  });
+}
+} // namespace mlir::tt::ttir
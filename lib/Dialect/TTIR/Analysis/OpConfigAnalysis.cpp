@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "ttmlir/Dialect/TTIR/Analysis/OpConfigAnalysis.h"
+#include "llvm/ADT/STLExtras.h"
 
 namespace mlir::tt::ttir {
 
@@ -15,12 +16,53 @@ bool OpConfigAnalysis::applyOverrides() {
 
 void OpConfigAnalysis::analysisImplementation() {
 
-  // Future entrypoint for picking optimal op config.
-  // Placeholder: pick the first legal grid.
+  // Pick the cheapest legal layout according to the cost model, or the first
+  // one if there is no cost model.
+  //
+  // First legal layout determines memory space and memory layout of the op.
+  // Only ops in shard chains were validated against L1 usage, so the choice is
+  // limited to layouts which differ from the first one in grid only. Ties
+  // keep the legal layout order.
+  //
+  // Layout tuned by an earlier compilation is reused without evaluating the
+  // rest if it is still one of the candidates.
   //
   for (auto opGrids : analysisInput.legalGrids) {
-    if (not opGrids.second.empty()) {
-      analysisResult[opGrids.first] = opGrids.second[0];
+    if (opGrids.second.empty()) {
+      continue;
+    }
+
+    LayoutAttr firstLayout = opGrids.second[0];
+    analysisResult[opGrids.first] = firstLayout;
+    if (analysisInput.tuningDatabase) {
+      std::optional<TuningRecord> tuned =
+          analysisInput.tuningDatabase->lookup(opGrids.first);
+      if (tuned &&
+          tuned->layout.getMemorySpace() == firstLayout.getMemorySpace() &&
+          tuned->layout.getMemLayout() == firstLayout.getMemLayout() &&
+          llvm::is_contained(opGrids.second, tuned->layout)) {
+        analysisResult[opGrids.first] = tuned->layout;
+        continue;
+      }
+    }
+
+    if (not analysisInput.costModel) {
+      continue;
+    }
+
+    double bestCost =
+        analysisInput.costModel->getOpCost(opGrids.first, firstLayout);
+    for (LayoutAttr layout : llvm::drop_begin(opGrids.second)) {
+      if (layout.getMemorySpace() != firstLayout.getMemorySpace() ||
+          layout.getMemLayout() != firstLayout.getMemLayout()) {
+        continue;
+      }
+
+      double cost = analysisInput.costModel->getOpCost(opGrids.first, layout);
+      if (cost < bestCost) {
+        bestCost = cost;
+        analysisResult[opGrids.first] = layout;
+      }
     }
   }
 }
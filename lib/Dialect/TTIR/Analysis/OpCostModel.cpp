@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/OpCostModel.h"
+#include "ttmlir/Utils.h"
+
+namespace mlir::tt::ttir {
+
+// Rough device characteristics, in cycles. These are not meant to be exact,
+// only to rank layouts of the same op against each other.
+//
+constexpr double kOpDispatchCycles = 10000;
+constexpr double kCoreLaunchCycles = 32;
+constexpr double kReshardDispatchCycles = 5000;
+constexpr double kCyclesPerTile = 256;
+constexpr double kL1BytesPerCycle = 64;
+constexpr double kNocBytesPerCycle = 32;
+constexpr double kDramBytesPerCyclePerChannel = 32;
+constexpr double kDramLatencyCycles = 500;
+constexpr int64_t kTileDim = 32;
+
+static int64_t getNumCores(LayoutAttr layout) {
+  return ttmlir::utils::volume(layout.getGrid().getShape());
+}
+
+static int64_t getNumTiles(ArrayRef<int64_t> tensorShape) {
+  int64_t numTiles = 1;
+  for (size_t i = 0; i < tensorShape.size(); ++i) {
+    bool isTiledDim = i + 2 >= tensorShape.size();
+    numTiles *= isTiledDim ? (tensorShape[i] + kTileDim - 1) / kTileDim
+                           : tensorShape[i];
+  }
+  return numTiles;
+}
+
+static uint64_t getTensorSizeBytes(ArrayRef<int64_t> tensorShape,
+                                   LayoutAttr layout) {
+  return ttmlir::utils::volume(tensorShape) * layout.getElementSizeBytes();
+}
+
+// Time needed to read or write the whole tensor in given layout. Sharded
+// tensors are accessed from local L1 of every core in parallel, interleaved
+// tensors are spread over all DRAM channels or L1 banks.
+//
+double AnalyticalOpCostModel::getMemoryCycles(ArrayRef<int64_t> tensorShape,
+                                              LayoutAttr layout) {
+  if (layout.getMemorySpace() == MemorySpace::DeviceDRAM) {
+    uint64_t sizeBytes = ttmlir::utils::alignUp<uint64_t>(
+        getTensorSizeBytes(tensorShape, layout),
+        chipDesc.getNocDRAMAddressAlignBytes());
+    return kDramLatencyCycles +
+           sizeBytes /
+               (chipDesc.getNumDramChannels() * kDramBytesPerCyclePerChannel);
+  }
+
+  if (layout.hasShardedL1TensorMemoryLayout()) {
+    uint64_t shardSizeBytes = ttmlir::utils::alignUp<uint64_t>(
+        layoutSizeCache->getLayoutSizeBytes(deviceAttr, tensorShape, layout,
+                                            layout.getMemorySpace()),
+        chipDesc.getNocL1AddressAlignBytes());
+    return shardSizeBytes / kL1BytesPerCycle;
+  }
+
+  // L1 interleaved, pages are fetched over NoC from all worker cores.
+  //
+  uint64_t sizeBytes = ttmlir::utils::alignUp<uint64_t>(
+      getTensorSizeBytes(tensorShape, layout),
+      chipDesc.getNocL1AddressAlignBytes());
+  return sizeBytes / (getNumCores(layout) * kNocBytesPerCycle);
+}
+
+double AnalyticalOpCostModel::getOpCost(Operation *op, LayoutAttr layout) {
+  ArrayRef<int64_t> tensorShape =
+      mlir::cast<RankedTensorType>(op->getResult(0).getType()).getShape();
+  int64_t numCores = getNumCores(layout);
+  int64_t tilesPerCore = (getNumTiles(tensorShape) + numCores - 1) / numCores;
+
+  double dispatchCycles = kOpDispatchCycles + numCores * kCoreLaunchCycles;
+  double computeCycles = tilesPerCore * kCyclesPerTile;
+  double memoryCycles = getMemoryCycles(tensorShape, layout);
+
+  return dispatchCycles + std::max(computeCycles, memoryCycles);
+}
+
+double AnalyticalOpCostModel::getReshardCost(RankedTensorType tensorType,
+                                             LayoutAttr srcLayout,
+                                             LayoutAttr dstLayout) {
+  if (srcLayout == dstLayout) {
+    return 0;
+  }
+
+  // Tensor is read in source layout and moved over NoC by the cores of the
+  // destination layout.
+  //
+  ArrayRef<int64_t> tensorShape = tensorType.getShape();
+  double transferCycles =
+      getTensorSizeBytes(tensorShape, dstLayout) /
+      (getNumCores(dstLayout) * kNocBytesPerCycle);
+
+  return kReshardDispatchCycles + getMemoryCycles(tensorShape, srcLayout) +
+         transferCycles;
+}
+
+} // namespace mlir::tt::ttir
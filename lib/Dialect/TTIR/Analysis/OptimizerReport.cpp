@@ -0,0 +1,185 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/OptimizerReport.h"
+#include "ttmlir/Dialect/TTIR/Analysis/MemoryScheduleAnalysis.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir::tt::ttir {
+
+static std::string getLayoutString(LayoutAttr layout) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  layout.print(os);
+  return os.str();
+}
+
+static std::string getOpLocName(Operation *op) {
+  if (NameLoc nameLoc = mlir::dyn_cast<NameLoc>(op->getLoc())) {
+    return nameLoc.getName().str();
+  }
+  return "";
+}
+
+static LayoutAttr getOpLayout(Operation *op,
+                              const OptimizerReportInput &input) {
+  LayoutAttr layout = input.opLayouts.lookup(op);
+  if (!layout) {
+    layout = mlir::dyn_cast_or_null<LayoutAttr>(
+        mlir::cast<RankedTensorType>(op->getResult(0).getType())
+            .getEncoding());
+  }
+  return layout;
+}
+
+// Bytes of the whole tensor, regardless of how it is spread over cores.
+//
+static uint64_t getTensorSizeBytes(Value value, LayoutAttr layout) {
+  RankedTensorType tensorType = mlir::cast<RankedTensorType>(value.getType());
+  Type scalarType =
+      layout ? layout.getScalarElementType() : tensorType.getElementType();
+  return tensorType.getNumElements() *
+         llvm::divideCeil(scalarType.getIntOrFloatBitWidth(), 8);
+}
+
+static llvm::json::Value buildFuncReport(func::FuncOp func,
+                                         ArrayRef<Operation *> schedule,
+                                         const OptimizerReportInput &input,
+                                         LayoutSizeCache *layoutSizeCache) {
+  DeviceAttr deviceAttr = getCurrentScopeDevice(func);
+  llvm::DenseMap<Operation *, int64_t> scheduleStep;
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    scheduleStep[schedule[i]] = i;
+  }
+
+  auto getStep = [&](Operation *op) -> llvm::json::Value {
+    auto step = scheduleStep.find(op);
+    if (step == scheduleStep.end()) {
+      return nullptr;
+    }
+    return step->second;
+  };
+
+  llvm::DenseMap<Operation *, size_t> numSolvedLayouts;
+  llvm::json::Array shardChains;
+  for (const ShardChainConfig &shardChainConfig : input.shardChainConfigs) {
+    const std::vector<ShardSpec> &shardSpecs =
+        shardChainConfig.getShardSpecs();
+    if (shardSpecs.empty() || !scheduleStep.contains(shardSpecs.front().op) ||
+        shardChainConfig.getState() == ShardChainState::Failed) {
+      continue;
+    }
+
+    llvm::json::Array chainOps;
+    for (const ShardSpec &shardSpec : shardSpecs) {
+      numSolvedLayouts[shardSpec.op] = shardSpec.numSolvedLayouts;
+      chainOps.push_back(getStep(shardSpec.op));
+    }
+    shardChains.push_back(llvm::json::Object{
+        {"ops", std::move(chainOps)},
+        {"split_factor", shardChainConfig.getTensorSplitFactor()}});
+  }
+
+  llvm::json::Array ops;
+  for (size_t i = 0; i < schedule.size(); ++i) {
+    Operation *op = schedule[i];
+    LayoutAttr layout = getOpLayout(op, input);
+    uint64_t l1Bytes = 0;
+    if (layout && layout.getMemorySpace() == MemorySpace::DeviceL1) {
+      l1Bytes = layoutSizeCache->getLayoutSizeBytes(
+          deviceAttr,
+          mlir::cast<RankedTensorType>(op->getResult(0).getType()).getShape(),
+          layout, MemorySpace::DeviceL1);
+    }
+
+    auto solved = numSolvedLayouts.find(op);
+    ops.push_back(llvm::json::Object{
+        {"step", static_cast<int64_t>(i)},
+        {"name", getOpLocName(op)},
+        {"op", op->getName().getStringRef()},
+        {"legal_layouts", input.numLegalLayouts.lookup(op)},
+        {"solved_layouts", solved == numSolvedLayouts.end()
+                               ? llvm::json::Value(nullptr)
+                               : llvm::json::Value(solved->second)},
+        {"layout", layout ? getLayoutString(layout) : ""},
+        {"l1_bytes", l1Bytes}});
+  }
+
+  // Reshard edges in order of their consumers.
+  //
+  std::vector<Edge> reshardedEdges;
+  for (const Edge &edge : input.reshardedEdges) {
+    if (scheduleStep.contains(edge.consumerOp)) {
+      reshardedEdges.push_back(edge);
+    }
+  }
+  llvm::sort(reshardedEdges, [&](const Edge &a, const Edge &b) {
+    return std::make_pair(scheduleStep.lookup(a.consumerOp), a.operandIndex) <
+           std::make_pair(scheduleStep.lookup(b.consumerOp), b.operandIndex);
+  });
+
+  llvm::json::Array reshards;
+  for (const Edge &edge : reshardedEdges) {
+    Value operand = edge.consumerOp->getOperand(edge.operandIndex);
+    reshards.push_back(llvm::json::Object{
+        {"producer", getStep(edge.producerOp)},
+        {"consumer", getStep(edge.consumerOp)},
+        {"operand", static_cast<int64_t>(edge.operandIndex)},
+        {"bytes", getTensorSizeBytes(
+                      operand, getOpLayout(edge.producerOp, input))}});
+  }
+
+  llvm::json::Array l1Timeline;
+  for (uint64_t l1Bytes :
+       getScheduleMemoryUsage(schedule, input.opLayouts, MemorySpace::DeviceL1,
+                              layoutSizeCache)) {
+    l1Timeline.push_back(l1Bytes);
+  }
+
+  return llvm::json::Object{{"name", func.getSymName()},
+                            {"ops", std::move(ops)},
+                            {"shard_chains", std::move(shardChains)},
+                            {"reshards", std::move(reshards)},
+                            {"l1_timeline", std::move(l1Timeline)}};
+}
+
+llvm::json::Value OptimizerReport::build(ModuleOp module,
+                                         const OptimizerReportInput &input,
+                                         LayoutSizeCache *layoutSizeCache) {
+  llvm::json::Array funcs;
+  module->walk([&](func::FuncOp func) {
+    auto schedule = input.schedule.find(func);
+    funcs.push_back(buildFuncReport(
+        func,
+        schedule != input.schedule.end() && !schedule->second.empty()
+            ? schedule->second
+            : getProgramOrderSchedule(func),
+        input, layoutSizeCache));
+  });
+
+  return llvm::json::Object{{"format_version", kFormatVersion},
+                            {"funcs", std::move(funcs)}};
+}
+
+LogicalResult OptimizerReport::write(const llvm::json::Value &report,
+                                     StringRef path) {
+  std::error_code error;
+  llvm::raw_fd_ostream os(path, error, llvm::sys::fs::OF_Text);
+  if (error) {
+    return failure();
+  }
+
+  os << llvm::formatv("{0:2}", report) << "\n";
+  os.close();
+  if (os.has_error()) {
+    os.clear_error();
+    return failure();
+  }
+
+  return success();
+}
+
+} // namespace mlir::tt::ttir
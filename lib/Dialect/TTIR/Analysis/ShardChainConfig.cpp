@@ -14,14 +14,22 @@ void ShardChainConfig::build() {
 
 ShardSolver ShardChainConfig::resolve(
     const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &legalLayouts,
-    unsigned usableL1CacheSize) {
+    unsigned usableL1CacheSize, LayoutSizeCache *layoutSizeCache) {
   assert(state == ShardChainState::Built);
 
   // Reconcile adjacent shard specs.
   // Generate reshard specs where needed.
   //
   ShardSolver shardSolver(legalLayouts, shardSpecs, shardedOps,
-                          usableL1CacheSize);
+                          usableL1CacheSize, layoutSizeCache);
+  if (!shardSolver.isResolved()) {
+    state = ShardChainState::Failed;
+    return shardSolver;
+  }
+
+  for (ShardSpec &shardSpec : shardSpecs) {
+    shardSpec.numSolvedLayouts = shardSolver.at(shardSpec.op).size();
+  }
   state = ShardChainState::Resolved;
 
   return shardSolver;
@@ -3,20 +3,21 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "ttmlir/Dialect/TTIR/Analysis/ShardSolver.h"
+#include "ttmlir/Dialect/TTIR/Analysis/L1Usage.h"
 #include "ttmlir/Dialect/TTIR/Analysis/ShardChainConfig.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TensorSplit.h"
 #include <mlir/Interfaces/DestinationStyleOpInterface.h>
 
 namespace mlir::tt::ttir {
 
-ShardSolver::Bitset ShardSolver::kBitsetAll = ~kBitsetNone;
-
 ShardSolver::ShardSolver(
     const llvm::DenseMap<Operation *, std::vector<LayoutAttr>> &legalLayouts,
     const std::vector<ShardSpec> &shardSpecs,
     const llvm::DenseSet<Operation *> &shardedOps,
-    const unsigned usableL1CacheSize)
+    const unsigned usableL1CacheSize, LayoutSizeCache *layoutSizeCache)
     : legalLayouts(&legalLayouts), shardSpecs(&shardSpecs),
-      shardedOps(&shardedOps), usableL1CacheSize(usableL1CacheSize) {
+      shardedOps(&shardedOps), usableL1CacheSize(usableL1CacheSize),
+      layoutSizeCache(layoutSizeCache) {
   pathSets.reserve(shardSpecs.size());
   pathSetIds.reserve(shardSpecs.size());
   bitsets.reserve(shardedOps.size());
@@ -26,6 +27,10 @@ ShardSolver::ShardSolver(
   //
   deviceAttr = getCurrentScopeDevice(shardSpecs.front().op);
 
+  // L1 usage is checked for one slice of every tensor.
+  //
+  tensorSplitFactor = shardSpecs.front().tensorSplitFactor;
+
   // Populate operandOpEdges and userOpEdges.
   //
   for (const auto shardSpec : shardSpecs) {
@@ -46,98 +51,44 @@ ShardSolver::ShardSolver(
   resolve();
 }
 
-void ShardSolver::reset() {
-  pathSets.clear();
-  pathSetIds.clear();
-  bitsets.clear();
-  bitsetIds.clear();
-}
-
-bool ShardSolver::resolveStep() {
+void ShardSolver::resolve() {
   OperationPathsProcessor opProcessor;
   bitsets.reserve(shardedOps->size());
   bitsetIds.reserve(shardedOps->size());
   selectedOpLayout.reserve(shardedOps->size());
-  bool reshardInserted = false;
 
-  // We need special handling for the first op in the chain.
+  // We need special handling for the first op in the chain. If no layout of
+  // the first op fits into L1 next to its input, the chain can't be sharded.
   //
-  preprocessFirstOp();
+  if (!preprocessFirstOp()) {
+    return;
+  }
 
   for (const auto shardSpec : *shardSpecs) {
     Operation *consumerOp = shardSpec.op;
-    Bitset *consumerBitset = getOrInsertBitset(consumerOp, kBitsetAll);
-    std::vector<LayoutAttr> const &consumerLayouts =
-        getLegalLayouts(consumerOp);
+    Bitset *consumerBitset = getOrInsertBitset(consumerOp);
 
     for (Edge edge : operandOpEdges[consumerOp]) {
-
-      bool reshardOnEdge = reshardedEdges.count(edge) > 0;
-
       Operation *producerOp = edge.producerOp;
-      Bitset *producerBitset = getOrInsertBitset(producerOp, kBitsetAll);
-      std::vector<LayoutAttr> const &producerLayouts =
-          getLegalLayouts(producerOp);
-
-      assert(not(consumerLayouts.empty() && producerLayouts.empty()));
-
-      PathSet::Paths paths;
-      Bitset edgeProducerBitset = kBitsetNone;
-      Bitset edgeConsumerBitset = kBitsetNone;
-      std::uint64_t producer_count =
-          std::min(kNumBitsetBits, std::max(1lu, producerLayouts.size()));
-      std::uint64_t consumer_count =
-          std::min(kNumBitsetBits, std::max(1lu, consumerLayouts.size()));
-      for (std::uint64_t producerId = 0; producerId < producer_count;
-           ++producerId) {
-        // If the producer cannot accomodate this path, continue.
-        // Also if this is not the LayoutAttr we selected, continue.
-        //
-        if (!producerBitset->test(producerId)) {
-          continue;
-        }
-
-        for (std::uint64_t consumerId = 0; consumerId < consumer_count;
-             ++consumerId) {
-
-          // If the consumer cannot accomodate this path, continue.
-          //
-          if (!consumerBitset->test(consumerId)) {
-            continue;
-          }
-
-          // TODO(nobradovic):
-          // Update checkShardCompatible with op type, other input
-          // spec(weight).
-          //
-          bool validShardPair =
-              reshardOnEdge ||
-              checkShardCompatible(producerOp, producerLayouts[producerId],
-                                   consumerOp, consumerLayouts[consumerId]);
-
-          if (validShardPair) {
-            assert(producerId <=
-                   std::numeric_limits<decltype(Path::producerId)>::max());
-            assert(consumerId <=
-                   std::numeric_limits<decltype(Path::consumerId)>::max());
-            paths.push_back(Path(producerId, consumerId));
-            edgeProducerBitset.set(producerId);
-            edgeConsumerBitset.set(consumerId);
-          }
-        }
-      }
+      Bitset *producerBitset = getOrInsertBitset(producerOp);
 
-      if (paths.empty() || ((*producerBitset & edgeProducerBitset) == 0) ||
-          ((*consumerBitset & edgeConsumerBitset) == 0)) {
+      Bitset edgeProducerBitset;
+      Bitset edgeConsumerBitset;
+      PathSet::Paths paths =
+          buildPaths(edge, edgeProducerBitset, edgeConsumerBitset);
 
-        // No valid paths found for this edge, mark it for resharding.
+      if (!producerBitset->anyCommon(edgeProducerBitset) ||
+          !consumerBitset->anyCommon(edgeConsumerBitset)) {
+
+        // No valid paths found for this edge, mark it for resharding. Reshard
+        // decouples producer and consumer layouts, so only this edge needs to
+        // be rebuilt, everything resolved so far stays valid.
         //
         insertReshard(edge);
-        reshardInserted = true;
-        *consumerBitset = kBitsetAll;
+        paths = buildPaths(edge, edgeProducerBitset, edgeConsumerBitset);
       }
 
-      if (!isSubset(*producerBitset, edgeProducerBitset) && !reshardInserted) {
+      if (!isSubset(*producerBitset, edgeProducerBitset)) {
         opProcessor.addOp(producerOp);
       }
 
@@ -145,18 +96,12 @@ bool ShardSolver::resolveStep() {
       *consumerBitset &= edgeConsumerBitset;
       assert(pathSetIds.find(edge) == pathSetIds.end());
       PathSetId pathSetId = static_cast<PathSetId>(pathSets.size());
-      pathSets.emplace_back(bitsetIds[producerOp], bitsetIds[consumerOp],
-                            producerOp, consumerOp, paths);
+      pathSets.emplace_back(bitsetIds[producerOp], bitsetIds[consumerOp], edge,
+                            paths);
       pathSetIds.emplace(edge, pathSetId);
     }
 
-    if (!reshardInserted) {
-      opProcessor.process(this);
-    }
-  }
-
-  if (reshardInserted) {
-    return false;
+    opProcessor.process(this);
   }
 
   for (const auto shardSpec : *shardSpecs) {
@@ -164,17 +109,69 @@ bool ShardSolver::resolveStep() {
 
     // No need to expand root as we are calling for all ops anyway.
     //
-    updateSolver(op, false /* expand_root */);
+    PathSetId failedPathSetId = -1;
+    while (!updateSolver(op, failedPathSetId, false /* expand_root */)) {
+      if (!handleNoPathsLeftOnUpdate(failedPathSetId)) {
+        trail.clear();
+        return;
+      }
+    }
+    trail.clear();
   }
 
-  return true;
+  chainResolved = true;
+}
+
+// Builds compatibility matrix of all valid producer/consumer layout pairs on
+// the edge. Resharded edges accept any pair. Layouts which take part in at
+// least one path are marked in edgeProducerBitset/edgeConsumerBitset.
+//
+ShardSolver::PathSet::Paths
+ShardSolver::buildPaths(const Edge &edge, Bitset &edgeProducerBitset,
+                        Bitset &edgeConsumerBitset) const {
+  Operation *producerOp = edge.producerOp;
+  Operation *consumerOp = edge.consumerOp;
+  Bitset const *producerBitset = getBitset(producerOp);
+  Bitset const *consumerBitset = getBitset(consumerOp);
+  std::vector<LayoutAttr> const &producerLayouts = getLegalLayouts(producerOp);
+  std::vector<LayoutAttr> const &consumerLayouts = getLegalLayouts(consumerOp);
+  bool reshardOnEdge = reshardedEdges.count(edge) > 0;
+
+  assert(not(consumerLayouts.empty() && producerLayouts.empty()));
+
+  PathSet::Paths paths(producerBitset->size(), Bitset(consumerBitset->size()));
+  edgeProducerBitset = Bitset(producerBitset->size());
+  edgeConsumerBitset = Bitset(consumerBitset->size());
+  for (int producerId : producerBitset->set_bits()) {
+    // If the producer cannot accomodate this path, it is skipped by
+    // set_bits(). Same goes for the consumer below.
+    //
+    for (int consumerId : consumerBitset->set_bits()) {
+      // TODO(nobradovic):
+      // Update checkShardCompatible with op type, other input
+      // spec(weight).
+      //
+      bool validShardPair =
+          reshardOnEdge ||
+          checkShardCompatible(producerOp, producerLayouts[producerId],
+                               consumerOp, consumerLayouts[consumerId]);
+
+      if (validShardPair) {
+        paths[producerId].set(consumerId);
+        edgeProducerBitset.set(producerId);
+        edgeConsumerBitset.set(consumerId);
+      }
+    }
+  }
+
+  return paths;
 }
 
 // We need to check if first op requires sharded inputs and if so, insert
 // reshard edge, then invalidate all sharding options which would go above L1
-// size limits.
+// size limits. Returns false if no sharding option of the first op is left.
 //
-void ShardSolver::preprocessFirstOp() {
+bool ShardSolver::preprocessFirstOp() {
   // TODO(nobradovic): Add check whether this op type can have sharded output
   // from interleaved inputs. For now assuming it can not.
   //
@@ -188,7 +185,7 @@ void ShardSolver::preprocessFirstOp() {
     insertReshard(shardChainInputEdge);
   }
 
-  Bitset *firstOpBitset = getOrInsertBitset(firstOp, kBitsetAll);
+  Bitset *firstOpBitset = getOrInsertBitset(firstOp);
   std::vector<LayoutAttr> const &firstOpLayouts = getLegalLayouts(firstOp);
   Operation *operandOp = firstOp->getOperand(0).getDefiningOp();
 
@@ -196,7 +193,6 @@ void ShardSolver::preprocessFirstOp() {
       mlir::cast<RankedTensorType>(operandOp->getResult(0).getType());
   LayoutAttr firstOpInputLayout =
       mlir::cast<LayoutAttr>(firstOpInputTensorType.getEncoding());
-  constexpr float tensorL1UsageCap = 0.8;
 
   for (size_t i = 0; i < firstOpLayouts.size(); ++i) {
     if (!firstOpBitset->test(i)) {
@@ -206,28 +202,36 @@ void ShardSolver::preprocessFirstOp() {
     LayoutAttr firstOpLayout = firstOpLayouts[i];
     assert(firstOpLayout.hasShardedL1TensorMemoryLayout());
 
+    llvm::SmallVector<int64_t> firstOpInputSplitShape =
+        getSplitShape(firstOpInputTensorType.getShape(), tensorSplitFactor);
     LayoutAttr firstOpInputShardedLayout =
         firstOpInputLayout
             .withMemorySpace(firstOp->getContext(),
                              firstOpLayout.getMemorySpace())
             .withMemoryLayout(firstOp->getContext(),
                               firstOpLayout.getMemLayout())
-            .withGrid(firstOp->getContext(), firstOpInputTensorType,
-                      firstOpLayout.getGrid());
+            .withGrid(firstOp->getContext(), firstOpInputSplitShape,
+                      firstOpLayout.getGrid())
+            .withTileAlignedShardShape(firstOp->getContext());
 
-    uint64_t firstInputL1Usage = deviceAttr.getLayoutSizeBytes(
-        firstOpInputTensorType.getShape(), firstOpInputShardedLayout,
+    uint64_t firstInputL1Usage = layoutSizeCache->getLayoutSizeBytes(
+        deviceAttr, firstOpInputSplitShape, firstOpInputShardedLayout,
         firstOpInputShardedLayout.getMemorySpace());
-    uint64_t firstOpL1OutputUsage = deviceAttr.getLayoutSizeBytes(
+    LayoutAttr firstOpSplitLayout = getSplitLayout(
+        firstOp->getContext(),
         mlir::cast<RankedTensorType>(firstOp->getResult(0).getType())
             .getShape(),
-        firstOpLayout, firstOpLayout.getMemorySpace());
+        firstOpLayout, tensorSplitFactor);
+    uint64_t firstOpL1OutputUsage =
+        getSplitOutputL1Usage(firstOp, firstOpLayout);
 
-    if ((firstInputL1Usage + firstOpL1OutputUsage) >=
-        tensorL1UsageCap * usableL1CacheSize) {
+    if ((firstInputL1Usage + firstOpL1OutputUsage +
+         getOpL1ExecUsage(firstOp, firstOpSplitLayout)) >= usableL1CacheSize) {
       firstOpBitset->reset(i);
     }
   }
+
+  return firstOpBitset->any();
 }
 
 void ShardSolver::insertReshard(const Edge &edge) {
@@ -237,26 +241,6 @@ void ShardSolver::insertReshard(const Edge &edge) {
   reshardedEdges.insert(edge);
 }
 
-void ShardSolver::resolve() {
-
-  const int max_retry_step = shardedOps->size() + 1;
-  int retry_step = 1;
-  bool resolved = false;
-
-  do {
-    // Reset ShardSolver to default state.
-    //
-    reset();
-
-    // Try to resolve shard chain. Retry if not resolved(resharding).
-    //
-    resolved = resolveStep();
-    retry_step++;
-  } while (!resolved && retry_step <= max_retry_step);
-
-  assert(resolved);
-}
-
 ShardSolver::PathSet *ShardSolver::getPathSetPt(const Edge &edge) {
   if (pathSetIds.count(edge) > 0) {
     return &pathSets[pathSetIds.at(edge)];
@@ -265,6 +249,13 @@ ShardSolver::PathSet *ShardSolver::getPathSetPt(const Edge &edge) {
   return nullptr;
 }
 
+ShardSolver::PathSetId
+ShardSolver::getPathSetId(const PathSet *pathSet) const {
+  assert(pathSet >= pathSets.data() &&
+         pathSet < pathSets.data() + pathSets.size());
+  return static_cast<PathSetId>(pathSet - pathSets.data());
+}
+
 SmallVector<ShardSolver::PathSet *>
 ShardSolver::getOperandPathSetsPts(Operation *op) {
   SmallVector<PathSet *> operandPathSets;
@@ -316,31 +307,90 @@ void ShardSolver::addOperandsAndUsers(Operation *op,
   }
 }
 
-void ShardSolver::handleNoPathsLeftOnUpdate(bool invokedBySet) {
+// Saves bitsets of the path set producer and consumer, unless they were
+// already saved during the current update.
+//
+void ShardSolver::saveToTrail(const PathSet *pathSet) {
+  for (BitsetId bitsetId :
+       {pathSet->getProducerSetId(), pathSet->getConsumerSetId()}) {
+    trail.try_emplace(bitsetId, bitsets[bitsetId]);
+  }
+}
+
+// Restores all state saved in the trail and clears it.
+//
+void ShardSolver::rollbackTrail() {
+  for (auto &[bitsetId, bitset] : trail) {
+    bitsets[bitsetId] = std::move(bitset);
+  }
+
+  trail.clear();
+}
+
+bool ShardSolver::handleNoPathsLeftOnUpdate(PathSetId pathSetId) {
   // We ended-up in a situation without valid solution due to circular
-  // dependency.
+  // dependency. Undo the failed update, reshard the edge which ran out of paths
+  // and rebuild its path set. Resharded edge accepts any pair of currently
+  // valid layouts, so no other path set or bitset needs to change.
   //
-  assert(invokedBySet);
-
-  // Invoking resolve again will use resharding to resolve the issue.
+  // Edge which is already resharded ran out of paths because one of its ops
+  // has no valid layout left, there is no solution then.
   //
-  return resolve();
+  rollbackTrail();
+
+  PathSet &pathSet = pathSets[pathSetId];
+  if (isResharded(pathSet.getEdge())) {
+    return false;
+  }
+
+  insertReshard(pathSet.getEdge());
+
+  Bitset edgeProducerBitset;
+  Bitset edgeConsumerBitset;
+  pathSet.setPaths(
+      buildPaths(pathSet.getEdge(), edgeProducerBitset, edgeConsumerBitset));
+  return true;
+}
+
+// Updates the path set, recording previous state of its bitsets to the trail.
+// Returns false and sets failedPathSetId if no valid paths are left.
+//
+bool ShardSolver::updatePathSet(PathSet *pathSet, bool &changed,
+                                PathSetId &failedPathSetId) {
+  saveToTrail(pathSet);
+  changed = pathSet->update(bitsets);
+
+  if (pathSet->empty(bitsets)) {
+    failedPathSetId = getPathSetId(pathSet);
+    return false;
+  }
+
+  return true;
 }
 
-void ShardSolver::updateSolver(Operation *root, bool expand_root,
-                               bool invokedBySet) {
+// Propagates bitset changes of the root op through the graph. Returns false if
+// some path set ran out of valid paths. In that case failedPathSetId is set and
+// the caller is expected to call handleNoPathsLeftOnUpdate.
+//
+bool ShardSolver::updateSolver(Operation *root, PathSetId &failedPathSetId,
+                               bool expand_root) {
   std::vector<Operation *> needsUpdate = {root};
+  bool changed = false;
 
   if (expand_root) {
     auto operandPathSets = getOperandPathSetsPts(root);
     auto userPathSets = getUserPathSetsPts(root);
 
     for (auto *path_set : operandPathSets) {
-      path_set->update(bitsets);
+      if (!updatePathSet(path_set, changed, failedPathSetId)) {
+        return false;
+      }
     }
 
     for (auto *path_set : userPathSets) {
-      path_set->update(bitsets);
+      if (!updatePathSet(path_set, changed, failedPathSetId)) {
+        return false;
+      }
     }
 
     // When op bitsets are updated(set of valid op layouts), we need to update
@@ -363,22 +413,18 @@ void ShardSolver::updateSolver(Operation *root, bool expand_root,
 
     std::vector<bool> producersChanged(operandPathSets.size());
     for (size_t i = 0; i < operandPathSets.size(); i++) {
-      auto *operandPathSet = operandPathSets[i];
-      producersChanged[i] = operandPathSet->update(bitsets);
-
-      if (operandPathSet->empty(bitsets)) {
-        return handleNoPathsLeftOnUpdate(invokedBySet);
+      if (!updatePathSet(operandPathSets[i], changed, failedPathSetId)) {
+        return false;
       }
+      producersChanged[i] = changed;
     }
 
     std::vector<bool> consumers_changed(userPathSets.size());
     for (size_t i = 0; i < userPathSets.size(); i++) {
-      auto *userPathSet = userPathSets[i];
-      consumers_changed[i] = userPathSet->update(bitsets);
-
-      if (userPathSet->empty(bitsets)) {
-        return handleNoPathsLeftOnUpdate(invokedBySet);
+      if (!updatePathSet(userPathSets[i], changed, failedPathSetId)) {
+        return false;
       }
+      consumers_changed[i] = changed;
     }
 
     // If any of the paths between producer and this consumer changed, we need
@@ -411,6 +457,8 @@ void ShardSolver::updateSolver(Operation *root, bool expand_root,
       needsUpdate.pop_back();
     }
   }
+
+  return true;
 }
 
 ShardSolver::Bitset *ShardSolver::getBitset(Operation *op) {
@@ -421,14 +469,16 @@ ShardSolver::Bitset const *ShardSolver::getBitset(Operation *op) const {
   return &bitsets[bitsetIds.at(op)];
 }
 
-ShardSolver::Bitset *ShardSolver::getOrInsertBitset(Operation *op,
-                                                    const Bitset &init) {
+// Returns bitset of valid layouts for passed in op. If the op is seen for the
+// first time, a bitset with all of its legal layouts enabled is created.
+//
+ShardSolver::Bitset *ShardSolver::getOrInsertBitset(Operation *op) {
   auto match = bitsetIds.find(op);
   if (match == bitsetIds.end()) {
     BitsetId bitset_id = bitsets.size();
     bitsetIds.insert({op, bitset_id});
     auto *tmp = bitsets.data();
-    bitsets.push_back(init);
+    bitsets.emplace_back(std::max<size_t>(1, getLegalLayouts(op).size()), true);
 
     // Bitsets reallocated, pointers invalid.
     //
@@ -455,6 +505,7 @@ ShardSolver::getLegalLayouts(Operation *op) const {
 }
 
 ShardSolver::RemainingLayoutAttrs ShardSolver::at(Operation *op) const {
+  assert(chainResolved && "Shard chain has no solution");
   auto layouts = RemainingLayoutAttrs(getLegalLayouts(op), *getBitset(op));
   assert(layouts.begin() != layouts.end());
   return layouts;
@@ -480,10 +531,47 @@ void ShardSolver::set(Operation *op, LayoutAttr const &layout) {
   assert(selection != layouts.size());
   assert((*op_bitset)[selection]);
 
-  op_bitset->reset();
-  op_bitset->set(selection);
+  BitsetId opBitsetId = bitsetIds.at(op);
+  PathSetId failedPathSetId = -1;
+  bool resolved = false;
+  do {
+    // Narrowing of the op bitset is recorded as well, so that it is undone
+    // together with the rest of a failed update and can be applied again.
+    //
+    trail.try_emplace(opBitsetId, *op_bitset);
+    op_bitset->reset();
+    op_bitset->set(selection);
 
-  updateSolver(op, true /*expand_root*/, true /*invokedBySet*/);
+    resolved = updateSolver(op, failedPathSetId, true /*expand_root*/);
+    if (!resolved) {
+      handleNoPathsLeftOnUpdate(failedPathSetId);
+    }
+  } while (!resolved);
+
+  trail.clear();
+}
+
+// Checks whether the pair of layouts is allowed on the edge in between two
+// sharded ops. Both layouts must also still be valid for their ops.
+//
+bool ShardSolver::isValidLayoutPair(const Edge &edge,
+                                    LayoutAttr const &producerLayout,
+                                    LayoutAttr const &consumerLayout) const {
+  auto pathSetIt = pathSetIds.find(edge);
+  assert(pathSetIt != pathSetIds.end());
+
+  auto const &producerLayouts = getLegalLayouts(edge.producerOp);
+  auto const &consumerLayouts = getLegalLayouts(edge.consumerOp);
+  size_t producerId =
+      llvm::find(producerLayouts, producerLayout) - producerLayouts.begin();
+  size_t consumerId =
+      llvm::find(consumerLayouts, consumerLayout) - consumerLayouts.begin();
+  assert(producerId < producerLayouts.size() &&
+         consumerId < consumerLayouts.size());
+
+  return getBitset(edge.producerOp)->test(producerId) &&
+         getBitset(edge.consumerOp)->test(consumerId) &&
+         pathSets[pathSetIt->second].hasPath(producerId, consumerId);
 }
 
 bool ShardSolver::checkShardCompatible(Operation *producerOp,
@@ -500,35 +588,42 @@ bool ShardSolver::checkShardCompatible(Operation *producerOp,
   // Need to plug shard checking API.
   //
 
-  // Need to plug API for L1 usage.
-  //
-  // Calculate L1 tensor memory usage based on :
-  // currentOp output tensor shard spec, nextOp exec and nextOp output
-  // tensor.
+  // Calculate L1 memory usage based on :
+  // currentOp output tensor shard spec, nextOp exec (circular buffers,
+  // scratch and program) and nextOp output tensor.
   //
   assert(producerLayout.hasShardedL1TensorMemoryLayout() &&
          consumerLayout.hasShardedL1TensorMemoryLayout());
-  RankedTensorType producerTensorType =
-      mlir::cast<RankedTensorType>(producerOp->getResult(0).getType());
-  uint64_t producerL1OutputUsage = deviceAttr.getLayoutSizeBytes(
-      producerTensorType.getShape(), producerLayout,
-      producerLayout.getMemorySpace());
-
-  RankedTensorType consumerTensorType =
-      mlir::cast<RankedTensorType>(consumerOp->getResult(0).getType());
-  uint64_t consumerL1OutputUsage = deviceAttr.getLayoutSizeBytes(
-      consumerTensorType.getShape(), consumerLayout,
-      consumerLayout.getMemorySpace());
-  // Figure out this const based on exec data, but will be replaced
-  // with API.
-  //
-  constexpr float tensorL1UsageCap = 0.8;
-  bool l1UsageValid = (producerL1OutputUsage + consumerL1OutputUsage) <
-                      tensorL1UsageCap * usableL1CacheSize;
+  uint64_t producerL1OutputUsage =
+      getSplitOutputL1Usage(producerOp, producerLayout);
+  uint64_t consumerL1OutputUsage =
+      getSplitOutputL1Usage(consumerOp, consumerLayout);
+  uint64_t consumerL1ExecUsage = getOpL1ExecUsage(
+      consumerOp,
+      getSplitLayout(
+          consumerOp->getContext(),
+          mlir::cast<RankedTensorType>(consumerOp->getResult(0).getType())
+              .getShape(),
+          consumerLayout, tensorSplitFactor));
+  bool l1UsageValid = (producerL1OutputUsage + consumerL1OutputUsage +
+                       consumerL1ExecUsage) < usableL1CacheSize;
 
   return l1UsageValid;
 }
 
+// L1 usage of one slice of the op output.
+//
+uint64_t ShardSolver::getSplitOutputL1Usage(Operation *op,
+                                            LayoutAttr layout) const {
+  llvm::ArrayRef<int64_t> tensorShape =
+      mlir::cast<RankedTensorType>(op->getResult(0).getType()).getShape();
+  LayoutAttr splitLayout =
+      getSplitLayout(op->getContext(), tensorShape, layout, tensorSplitFactor);
+  return layoutSizeCache->getLayoutSizeBytes(
+      deviceAttr, getSplitShape(tensorShape, tensorSplitFactor), splitLayout,
+      splitLayout.getMemorySpace());
+}
+
 // Returns ShardSolverSolution.
 //
 ShardSolverSolution const ShardSolver::finish() {
@@ -3,7 +3,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "ttmlir/Dialect/TTIR/Analysis/ShardingAnalysis.h"
+#include "ttmlir/Dialect/TTIR/Analysis/DAGShardingPolicy.h"
 #include "ttmlir/Dialect/TTIR/Analysis/DFShardingPolicy.h"
+#include "ttmlir/Dialect/TTIR/Analysis/DPShardingPolicy.h"
 
 namespace mlir::tt::ttir {
 
@@ -33,16 +35,35 @@ llvm::DenseMap<Operation *, std::vector<LayoutAttr>> filterShardedOnly(
 }
 
 void ShardingAnalysis::analysisImplementation() {
-  ShardingPolicyType policy = ShardingPolicyType::DFSharding;
-
-  switch (policy) {
-  case ShardingPolicyType::DFSharding:
+  switch (analysisInput.policy) {
+  case ShardingPolicyType::DFSharding: {
     DFShardingPolicy dfShardingPolicy(
         op, shardChainConfigs, filterShardedOnly(analysisInput.legalLayouts),
-        analysisResult.schedule, analysisInput.usableL1CacheSize);
+        analysisResult.schedule, analysisInput.usableL1CacheSize,
+        analysisInput.layoutSizeCache, analysisInput.costModel,
+        analysisInput.tuningDatabase);
     dfShardingPolicy.run();
     break;
   }
+  case ShardingPolicyType::DPSharding: {
+    DPShardingPolicy dpShardingPolicy(
+        op, shardChainConfigs, filterShardedOnly(analysisInput.legalLayouts),
+        analysisResult.schedule, analysisInput.usableL1CacheSize,
+        analysisInput.layoutSizeCache, analysisInput.costModel,
+        analysisInput.tuningDatabase);
+    dpShardingPolicy.run();
+    break;
+  }
+  case ShardingPolicyType::DAGSharding: {
+    DAGShardingPolicy dagShardingPolicy(
+        op, shardChainConfigs, filterShardedOnly(analysisInput.legalLayouts),
+        analysisResult.schedule, analysisInput.usableL1CacheSize,
+        analysisInput.layoutSizeCache, analysisInput.costModel,
+        analysisInput.tuningDatabase, analysisInput.l1SpillEnabled);
+    dagShardingPolicy.run();
+    break;
+  }
+  }
 
   // Copy over default legal layouts.
   //
@@ -51,6 +72,10 @@ void ShardingAnalysis::analysisImplementation() {
   // Override with shard chain configs where applicable.
   //
   for (const auto &shardChainConfig : shardChainConfigs) {
+    if (shardChainConfig.getState() == ShardChainState::Failed) {
+      continue;
+    }
+
     assert(shardChainConfig.getState() == ShardChainState::Completed);
     for (const auto &shardSpec : shardChainConfig.getShardSpecs()) {
       analysisResult.legalLayouts[shardSpec.op] =
@@ -60,6 +85,17 @@ void ShardingAnalysis::analysisImplementation() {
     analysisResult.reshardedEdges.insert(
         shardChainConfig.getReshardedEdges().begin(),
         shardChainConfig.getReshardedEdges().end());
+
+    if (shardChainConfig.getTensorSplitFactor() > 1) {
+      TensorSplitChain tensorSplitChain;
+      tensorSplitChain.splitFactor = shardChainConfig.getTensorSplitFactor();
+      for (const auto &shardSpec : shardChainConfig.getShardSpecs()) {
+        tensorSplitChain.ops.push_back(shardSpec.op);
+      }
+      analysisResult.tensorSplitChains.push_back(std::move(tensorSplitChain));
+    }
   }
+
+  analysisResult.shardChainConfigs = shardChainConfigs;
 }
 } // namespace mlir::tt::ttir
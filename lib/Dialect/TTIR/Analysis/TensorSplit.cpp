@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/TensorSplit.h"
+#include "ttmlir/Dialect/TTIR/IR/TTIROps.h"
+#include "mlir/Interfaces/DestinationStyleOpInterface.h"
+
+namespace mlir::tt::ttir {
+
+static bool hasSameOuterDim(Value operand, RankedTensorType resultType) {
+  RankedTensorType operandType =
+      mlir::dyn_cast<RankedTensorType>(operand.getType());
+  return operandType && operandType.getRank() == resultType.getRank() &&
+         operandType.getDimSize(0) == resultType.getDimSize(0);
+}
+
+bool canSplitAlongOuterDim(Operation *op) {
+  if (op->getNumResults() != 1) {
+    return false;
+  }
+
+  RankedTensorType resultType =
+      mlir::dyn_cast<RankedTensorType>(op->getResult(0).getType());
+  if (!resultType || resultType.getRank() < 2) {
+    return false;
+  }
+
+  // Rows of elementwise ops are independent as long as no input is broadcast
+  // along the outer dim.
+  //
+  if (llvm::isa<ElementwiseOp>(op)) {
+    auto dpsOp = llvm::cast<DestinationStyleOpInterface>(op);
+    return llvm::all_of(dpsOp.getDpsInputs(), [&](Value input) {
+      return hasSameOuterDim(input, resultType);
+    });
+  }
+
+  // Rows of the output only depend on the same rows of the first input.
+  //
+  if (auto matmulOp = llvm::dyn_cast<MatmulOp>(op)) {
+    return resultType.getRank() == 2 &&
+           matmulOp.getA().getType().getRank() == 2 &&
+           matmulOp.getB().getType().getRank() == 2;
+  }
+
+  // Softmax along any dim other than the outer one.
+  //
+  if (auto softmaxOp = llvm::dyn_cast<SoftmaxOp>(op)) {
+    int32_t dimension = softmaxOp.getDimension();
+    if (dimension < 0) {
+      dimension += resultType.getRank();
+    }
+    return dimension != 0;
+  }
+
+  return false;
+}
+
+bool isSplitOperand(Operation *op, unsigned operandIndex) {
+  if (auto dpsOp = llvm::dyn_cast<DestinationStyleOpInterface>(op)) {
+    if (dpsOp.isDpsInit(&op->getOpOperand(operandIndex))) {
+      return false;
+    }
+  }
+
+  if (llvm::isa<MatmulOp>(op)) {
+    return operandIndex == 0;
+  }
+
+  return hasSameOuterDim(
+      op->getOperand(operandIndex),
+      mlir::cast<RankedTensorType>(op->getResult(0).getType()));
+}
+
+bool isValidSplitFactor(RankedTensorType tensorType, LayoutAttr layout,
+                        unsigned splitFactor) {
+  if (splitFactor == 1) {
+    return true;
+  }
+
+  if (tensorType.getRank() < 2 || tensorType.getDimSize(0) % splitFactor) {
+    return false;
+  }
+
+  // All dims but the last one are collapsed into tile rows. Device ops work on
+  // 32x32 tiles even if tensor is not tiled yet.
+  //
+  int64_t tileHeight = 32;
+  if (TileType tileType = mlir::dyn_cast<TileType>(layout.getElementType())) {
+    tileHeight = tileType.getHeight();
+  }
+
+  int64_t sliceRows = tensorType.getDimSize(0) / splitFactor;
+  for (int64_t dim = 1; dim < tensorType.getRank() - 1; ++dim) {
+    sliceRows *= tensorType.getDimSize(dim);
+  }
+
+  return sliceRows % tileHeight == 0;
+}
+
+llvm::SmallVector<int64_t> getSplitShape(ArrayRef<int64_t> tensorShape,
+                                         unsigned splitFactor) {
+  llvm::SmallVector<int64_t> splitShape(tensorShape);
+  splitShape[0] /= splitFactor;
+  return splitShape;
+}
+
+LayoutAttr getSplitLayout(MLIRContext *context, ArrayRef<int64_t> tensorShape,
+                          LayoutAttr layout, unsigned splitFactor) {
+  if (splitFactor == 1) {
+    return layout;
+  }
+
+  // Slice shards keep whole tiles same as shards of the layout.
+  LayoutAttr splitLayout = layout.withGrid(
+      context, getSplitShape(tensorShape, splitFactor), layout.getGrid());
+  if (layout.hasShardedTensorMemoryLayout()) {
+    return splitLayout.withTileAlignedShardShape(context);
+  }
+  return splitLayout;
+}
+
+} // namespace mlir::tt::ttir
@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ttmlir/Dialect/TTIR/Analysis/TuningDatabase.h"
+#include "mlir/AsmParser/AsmParser.h"
+#include "mlir/IR/Diagnostics.h"
+#include "ttmlir/Target/Common/tuning_db_generated.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir::tt::ttir {
+
+template <typename T> static std::string printToString(T value) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  value.print(os);
+  return os.str();
+}
+
+std::string TuningDatabase::getOpSignature(Operation *op) {
+  std::string signature;
+  llvm::raw_string_ostream os(signature);
+  os << op->getName() << "(";
+  llvm::interleaveComma(op->getOperandTypes(), os);
+  os << ") -> (";
+  llvm::interleaveComma(op->getResultTypes(), os);
+  os << ")";
+  return os.str();
+}
+
+std::optional<TuningRecord> TuningDatabase::lookup(Operation *op) const {
+  auto recorded = recordedRecords.find(getOpSignature(op));
+  if (recorded != recordedRecords.end()) {
+    return recorded->second;
+  }
+
+  return lookupImported(op);
+}
+
+std::optional<TuningRecord>
+TuningDatabase::lookupImported(Operation *op) const {
+  auto imported = importedRecords.find(getOpSignature(op));
+  if (imported == importedRecords.end()) {
+    return std::nullopt;
+  }
+
+  return imported->second;
+}
+
+void TuningDatabase::record(Operation *op, LayoutAttr layout, double latency,
+                            bool measured) {
+  if (!measured) {
+    std::optional<TuningRecord> existing = lookup(op);
+    if (existing && existing->measured && existing->layout == layout) {
+      return;
+    }
+  }
+
+  recordedRecords[getOpSignature(op)] = TuningRecord{layout, latency, measured};
+}
+
+LogicalResult TuningDatabase::import(Location loc, StringRef path) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
+      llvm::MemoryBuffer::getFile(path, /*IsText=*/false,
+                                  /*RequiresNullTerminator=*/false);
+  if (!buffer) {
+    return failure();
+  }
+
+  flatbuffers::Verifier verifier(
+      reinterpret_cast<const uint8_t *>((*buffer)->getBufferStart()),
+      (*buffer)->getBufferSize());
+  if (!::tt::target::VerifySizePrefixedTuningDatabaseBuffer(verifier)) {
+    return failure();
+  }
+
+  const ::tt::target::TuningDatabase *database =
+      ::tt::target::GetSizePrefixedTuningDatabase(
+          (*buffer)->getBufferStart());
+  if (database->format_version() != kFormatVersion ||
+      !database->system_desc_fingerprint() ||
+      database->system_desc_fingerprint()->string_view() != fingerprint ||
+      !database->records()) {
+    return success();
+  }
+
+  // Records are replaced only once every record is valid so a failed import
+  // leaves earlier records intact.
+  //
+  llvm::StringMap<TuningRecord> records;
+  for (const ::tt::target::TuningRecord *record : *database->records()) {
+    if (!record->op_signature() || !record->layout()) {
+      return failure();
+    }
+
+    // Layout might not parse anymore if the layout attribute syntax changed
+    // since the file was written. Parser errors are replaced by a warning
+    // naming the skipped record.
+    //
+    LayoutAttr layout;
+    {
+      ScopedDiagnosticHandler silenceParser(
+          loc.getContext(), [](Diagnostic &) { return success(); });
+      layout = mlir::dyn_cast_or_null<LayoutAttr>(
+          parseAttribute(record->layout()->string_view(), loc.getContext()));
+    }
+    if (!layout) {
+      emitWarning(loc) << "skipping tuning record of "
+                       << record->op_signature()->string_view()
+                       << " with invalid layout "
+                       << record->layout()->string_view();
+      continue;
+    }
+
+    records[record->op_signature()->string_view()] =
+        TuningRecord{layout, record->latency(), record->measured()};
+  }
+
+  importedRecords = std::move(records);
+  return success();
+}
+
+LogicalResult TuningDatabase::exportTo(StringRef path) const {
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<::tt::target::TuningRecord>> records;
+  for (const auto &imported : importedRecords) {
+    if (recordedRecords.contains(imported.first())) {
+      continue;
+    }
+
+    records.push_back(::tt::target::CreateTuningRecordDirect(
+        fbb, imported.first().str().c_str(),
+        printToString(imported.second.layout).c_str(),
+        imported.second.latency, imported.second.measured));
+  }
+
+  for (const auto &recorded : recordedRecords) {
+    records.push_back(::tt::target::CreateTuningRecordDirect(
+        fbb, recorded.first().str().c_str(),
+        printToString(recorded.second.layout).c_str(),
+        recorded.second.latency, recorded.second.measured));
+  }
+
+  auto database = ::tt::target::CreateTuningDatabaseDirect(
+      fbb, kFormatVersion, fingerprint.c_str(), &records);
+  ::tt::target::FinishSizePrefixedTuningDatabaseBuffer(fbb, database);
+
+  // Written to a temporary file first so a failed write never leaves a
+  // truncated database behind.
+  //
+  int fd;
+  llvm::SmallString<128> tmpPath;
+  if (llvm::sys::fs::createUniqueFile(path + "-%%%%%%.tmp", fd, tmpPath)) {
+    return failure();
+  }
+
+  llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+  os.write(reinterpret_cast<const char *>(fbb.GetBufferPointer()),
+           fbb.GetSize());
+  os.close();
+  if (os.has_error()) {
+    os.clear_error();
+    llvm::sys::fs::remove(tmpPath);
+    return failure();
+  }
+
+  if (llvm::sys::fs::rename(tmpPath, path)) {
+    llvm::sys::fs::remove(tmpPath);
+    return failure();
+  }
+
+  return success();
+}
+
+size_t TuningDatabase::size() const {
+  size_t numRecords = recordedRecords.size();
+  for (const auto &imported : importedRecords) {
+    if (!recordedRecords.contains(imported.first())) {
+      numRecords++;
+    }
+  }
+
+  return numRecords;
+}
+
+} // namespace mlir::tt::ttir
@@ -233,6 +233,53 @@ void mlir::tt::ttir::DivOp::buildGenericRegion(::mlir::OpBuilder &opBuilder,
   return success();
 }
 
+::mlir::LogicalResult mlir::tt::ttir::SliceOp::verify() {
+  ::mlir::RankedTensorType inputType = getInput().getType();
+  ::mlir::RankedTensorType outputType = getOutput().getType();
+  ::mlir::ArrayAttr begins = getBegins();
+  ::mlir::ArrayAttr ends = getEnds();
+  ::mlir::ArrayAttr step = getStep();
+  int64_t rank = inputType.getRank();
+
+  if (outputType.getRank() != rank) {
+    return emitOpError("Input and output tensors must have the same rank");
+  }
+
+  if (static_cast<int64_t>(begins.size()) != rank ||
+      static_cast<int64_t>(ends.size()) != rank ||
+      static_cast<int64_t>(step.size()) != rank) {
+    return emitOpError(
+        "Begins, ends and step attributes must match input tensor rank");
+  }
+
+  for (int64_t i = 0; i < rank; i++) {
+    int64_t dimBegin = mlir::cast<IntegerAttr>(begins[i]).getInt();
+    int64_t dimEnd = mlir::cast<IntegerAttr>(ends[i]).getInt();
+    int64_t dimStep = mlir::cast<IntegerAttr>(step[i]).getInt();
+
+    if (dimStep <= 0) {
+      return emitOpError() << "Step must be positive, got " << dimStep
+                           << " for dimension " << i << ".";
+    }
+
+    if (dimBegin < 0 || dimBegin >= dimEnd ||
+        dimEnd > inputType.getDimSize(i)) {
+      return emitOpError() << "Invalid slice [" << dimBegin << ", " << dimEnd
+                           << ") for dimension " << i << " of size "
+                           << inputType.getDimSize(i) << ".";
+    }
+
+    int64_t expectedDimSize = (dimEnd - dimBegin + dimStep - 1) / dimStep;
+    if (outputType.getDimSize(i) != expectedDimSize) {
+      return emitOpError() << "Output dimension " << i << " must be "
+                           << expectedDimSize << ", got "
+                           << outputType.getDimSize(i) << ".";
+    }
+  }
+
+  return success();
+}
+
 ::mlir::LogicalResult mlir::tt::ttir::ReshapeOp::verify() {
   ::mlir::RankedTensorType inputType = getInput().getType();
   ::mlir::RankedTensorType outputType = getOutput().getType();
@@ -562,6 +609,20 @@ void mlir::tt::ttir::DivOp::buildGenericRegion(::mlir::OpBuilder &opBuilder,
 }
 // ANCHOR_END: adding_an_op_matmul_ttir_verify
 
+// Double buffered input blocks, one tile deep in K, and intermediate partials
+// of the whole output shard.
+uint64_t mlir::tt::ttir::MatmulOp::getOpL1ScratchUsage(
+    mlir::tt::LayoutAttr outputLayout) {
+  llvm::SmallVector<int64_t> shardShape = outputLayout.getShardShape();
+  int64_t shardRows = shardShape.size() > 1 ? shardShape.rbegin()[1] : 1;
+  int64_t shardCols = shardShape.back();
+  uint64_t mTiles = (shardRows + 31) / 32;
+  uint64_t nTiles = (shardCols + 31) / 32;
+
+  return (2 * mTiles + 2 * nTiles + mTiles * nTiles) *
+         detail::getTileSizeBytes(outputLayout);
+}
+
 ::mlir::LogicalResult mlir::tt::ttir::Conv2dOp::verify() {
   ::mlir::RankedTensorType inputType = getInput().getType();
   ::mlir::RankedTensorType weightType = getWeight().getType();
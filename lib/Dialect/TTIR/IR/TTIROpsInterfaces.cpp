@@ -51,3 +51,16 @@ mlir::tt::ttir::detail::verifyElementwiseOp(mlir::Operation *op) {
 
   return success();
 }
+
+uint64_t mlir::tt::ttir::detail::getTileSizeBytes(mlir::tt::LayoutAttr layout) {
+  if (layout.isTiled()) {
+    return layout.getElementSizeBytes();
+  }
+
+  return 32 * 32 * layout.getElementSizeBytes();
+}
+
+uint64_t mlir::tt::ttir::detail::getDefaultOpL1ScratchUsage(
+    mlir::Operation *op, mlir::tt::LayoutAttr outputLayout) {
+  return 2 * op->getNumOperands() * getTileSizeBytes(outputLayout);
+}
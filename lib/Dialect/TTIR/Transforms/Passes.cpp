@@ -10,7 +10,9 @@
 #include "mlir/Dialect/MLProgram/IR/MLProgram.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Tosa/IR/TosaOps.h"
+#include "mlir/IR/IRMapping.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Rewrite/FrozenRewritePatternSet.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
@@ -18,14 +20,27 @@
 #include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
 #include "ttmlir/Dialect/TTIR/IR/TTIROps.h"
 
+#include "ttmlir/Dialect/TTIR/Analysis/L1SpillAnalysis.h"
+#include "ttmlir/Dialect/TTIR/Analysis/L1Usage.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutOverrideMatcher.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
 #include "ttmlir/Dialect/TTIR/Analysis/LegalGridAnalysis.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LegalLayoutCache.h"
+#include "ttmlir/Dialect/TTIR/Analysis/MemoryScheduleAnalysis.h"
 #include "ttmlir/Dialect/TTIR/Analysis/OpConfigAnalysis.h"
+#include "ttmlir/Dialect/TTIR/Analysis/OpCostModel.h"
+#include "ttmlir/Dialect/TTIR/Analysis/OptimizerReport.h"
 #include "ttmlir/Dialect/TTIR/Analysis/ShardingAnalysis.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TensorSplit.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TuningDatabase.h"
 #include "ttmlir/Dialect/TTIR/Transforms/Passes.h"
 #include "ttmlir/Utils.h"
 #include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/MapVector.h>
 #include <llvm/Support/Casting.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/LogicalResult.h>
+#include <map>
 #include <mlir/IR/BuiltinAttributes.h>
 #include <mlir/IR/Operation.h>
 #include <mlir/IR/Value.h>
@@ -35,11 +50,13 @@ namespace mlir::tt::ttir {
 #define GEN_PASS_DEF_TTIRSLIDINGWINDOW2DFIXSHAPES
 #define GEN_PASS_DEF_TTIRGENERICKERNEL
 #define GEN_PASS_DEF_TTIRGENERICREGION
+#define GEN_PASS_DEF_TTIRGENERICFUSE
 #define GEN_PASS_DEF_TTIRGENERICREGIONOPERANDSTOMEMREF
 #define GEN_PASS_DEF_TTIRLAYOUT
 #define GEN_PASS_DEF_TTIRSPLITCOMPOUNDLAYOUT
 #define GEN_PASS_DEF_TTIRCONSTANTASFILL
 #define GEN_PASS_DEF_TTIRALLOCATE
+#define GEN_PASS_DEF_TTIRVALIDATEMEMORYPLAN
 #define GEN_PASS_DEF_TTIROPTIMIZER
 #define GEN_PASS_DEF_TTIRIMPLICITDEVICE
 #define GEN_PASS_DEF_TTIRLOADSYSTEMDESC
@@ -329,6 +346,210 @@ public:
   }
 };
 
+class TTIRGenericFuse : public impl::TTIRGenericFuseBase<TTIRGenericFuse> {
+public:
+  using impl::TTIRGenericFuseBase<TTIRGenericFuse>::TTIRGenericFuseBase;
+
+  static bool isElementwise(GenericOp op) {
+    return llvm::all_of(op.getIndexingMaps(),
+                        [](Attribute map) {
+                          return mlir::cast<AffineMapAttr>(map)
+                              .getValue()
+                              .isIdentity();
+                        }) &&
+           llvm::all_of(op.getIteratorTypes(), [](Attribute iteratorType) {
+             return mlir::cast<IteratorTypeAttr>(iteratorType).getValue() ==
+                    IteratorType::Parallel;
+           });
+  }
+
+  // Region is a chain of tile ops yielding a single tile, e.g. built by
+  // ttir-generic, rather than a TTIR kernel.
+  //
+  static bool hasTileOpRegion(GenericOp op) {
+    Region &region = op.getRegion();
+    if (!region.hasOneBlock() ||
+        region.front().getTerminator()->getNumOperands() != 1) {
+      return false;
+    }
+
+    return llvm::all_of(region.front().without_terminator(),
+                        [](Operation &tileOp) {
+                          return !isa<KernelOp>(tileOp) &&
+                                 tileOp.getNumRegions() == 0 &&
+                                 tileOp.getNumResults() == 1;
+                        });
+  }
+
+  // Every tile op of the consumer must take the tile of the previous one,
+  // starting with the result of the producer, so that the chain can stay in
+  // dst register. Binary tile ops read their other operand from an input and
+  // must be commutative, as the tile in dst register becomes their first
+  // operand.
+  //
+  static bool isTileOpChain(GenericOp consumer, unsigned inputIndex) {
+    Block &block = consumer.getRegion().front();
+    Value chain = block.getArgument(inputIndex);
+    for (Operation &tileOp : block.without_terminator()) {
+      if (tileOp.getNumOperands() > 2 ||
+          llvm::count(tileOp.getOperands(), chain) != 1) {
+        return false;
+      }
+
+      if (tileOp.getNumOperands() == 2) {
+        Value other = tileOp.getOperand(tileOp.getOperand(0) == chain ? 1 : 0);
+        auto arg = mlir::dyn_cast<BlockArgument>(other);
+        if (!tileOp.hasTrait<OpTrait::IsCommutative>() || !arg ||
+            arg.getOwner() != &block || arg.getArgNumber() == inputIndex ||
+            arg.getArgNumber() >= consumer.getNumDpsInputs()) {
+          return false;
+        }
+      }
+      chain = tileOp.getResult(0);
+    }
+
+    return block.getTerminator()->getOperand(0) == chain;
+  }
+
+  static bool canFuse(GenericOp producer, GenericOp consumer,
+                      unsigned inputIndex) {
+    if (producer->getNumResults() != 1 || consumer->getNumResults() != 1 ||
+        !producer->getResult(0).hasOneUse() ||
+        producer->getBlock() != consumer->getBlock()) {
+      return false;
+    }
+
+    if (producer.getGrid() != consumer.getGrid() ||
+        producer->getResult(0).getType() != consumer->getResult(0).getType() ||
+        producer.getIteratorTypes() != consumer.getIteratorTypes() ||
+        !isElementwise(producer) || !isElementwise(consumer)) {
+      return false;
+    }
+
+    // Every input of the fused op gets its own circular buffer, and a
+    // dispatch has eight input ports.
+    //
+    constexpr int64_t maxInputs = 8;
+    if (producer.getNumDpsInputs() + consumer.getNumDpsInputs() - 1 >
+        maxInputs) {
+      return false;
+    }
+
+    return hasTileOpRegion(producer) && hasTileOpRegion(consumer) &&
+           isTileOpChain(consumer, inputIndex);
+  }
+
+  // Builds generic op with inputs of the producer, the other inputs of the
+  // consumer and outputs of the consumer, whose region runs tile ops of the
+  // producer followed by tile ops of the consumer on their result.
+  //
+  static GenericOp fuse(GenericOp producer, GenericOp consumer,
+                        unsigned inputIndex, OpBuilder &builder) {
+    int64_t numProducerInputs = producer.getNumDpsInputs();
+    int64_t numConsumerInputs = consumer.getNumDpsInputs();
+    SmallVector<Value> inputs(producer.getInputs().begin(),
+                              producer.getInputs().end());
+    SmallVector<Attribute> constraints(
+        producer.getOperandConstraints().getValue().take_front(
+            numProducerInputs));
+    for (auto [index, input] : llvm::enumerate(consumer.getInputs())) {
+      if (index != inputIndex) {
+        inputs.push_back(input);
+        constraints.push_back(consumer.getOperandConstraints()[index]);
+      }
+    }
+    int64_t numInputs = inputs.size();
+    llvm::append_range(constraints,
+                       consumer.getOperandConstraints().getValue().drop_front(
+                           numConsumerInputs));
+    SmallVector<Attribute> indexingMaps(constraints.size(),
+                                        consumer.getIndexingMaps()[0]);
+
+    builder.setInsertionPoint(consumer);
+    GenericOp fused = builder.create<GenericOp>(
+        consumer.getLoc(), consumer->getResultTypes(), inputs,
+        consumer.getOutputs(), consumer.getGrid(),
+        builder.getArrayAttr(indexingMaps), consumer.getIteratorTypes(),
+        builder.getArrayAttr(constraints));
+
+    Block *producerBlock = &producer.getRegion().front();
+    Block *consumerBlock = &consumer.getRegion().front();
+    Block *block = builder.createBlock(&fused.getRegion());
+    IRMapping mapping;
+    for (BlockArgument arg : producerBlock->getArguments().take_front(
+             numProducerInputs)) {
+      mapping.map(arg, block->addArgument(arg.getType(), arg.getLoc()));
+    }
+    for (BlockArgument arg : consumerBlock->getArguments()) {
+      if (arg.getArgNumber() != inputIndex) {
+        mapping.map(arg, block->addArgument(arg.getType(), arg.getLoc()));
+      }
+    }
+
+    // Producer output is never written to memory, its tile ops write to the
+    // consumer output instead.
+    //
+    for (BlockArgument arg :
+         producerBlock->getArguments().drop_front(numProducerInputs)) {
+      mapping.map(arg, block->getArgument(numInputs));
+    }
+
+    for (Operation &tileOp : producerBlock->without_terminator()) {
+      builder.clone(tileOp, mapping);
+    }
+    mapping.map(consumerBlock->getArgument(inputIndex),
+                mapping.lookupOrDefault(
+                    producerBlock->getTerminator()->getOperand(0)));
+    for (Operation &tileOp : *consumerBlock) {
+      builder.clone(tileOp, mapping);
+    }
+
+    return fused;
+  }
+
+  void runOnOperation() final {
+    SmallVector<GenericOp> consumers;
+    getOperation()->walk([&](GenericOp op) { consumers.push_back(op); });
+
+    // Consumers are visited in program order, so chains are fused front to
+    // back, every fused op becoming producer of the next consumer.
+    //
+    OpBuilder builder(&getContext());
+    for (GenericOp consumer : consumers) {
+      GenericOp producer;
+      unsigned inputIndex = 0;
+      for (auto [index, input] : llvm::enumerate(consumer.getInputs())) {
+        auto candidate = input.getDefiningOp<GenericOp>();
+        if (candidate && canFuse(candidate, consumer, index)) {
+          producer = candidate;
+          inputIndex = index;
+          break;
+        }
+      }
+      if (!producer) {
+        continue;
+      }
+
+      GenericOp fused = fuse(producer, consumer, inputIndex, builder);
+      consumer->replaceAllUsesWith(fused);
+      consumer->erase();
+
+      Value producerInit = producer.getOutputs()[0];
+      producer->erase();
+      tensor::EmptyOp empty = producerInit.getDefiningOp<tensor::EmptyOp>();
+      if (empty && empty->use_empty()) {
+        empty->erase();
+      }
+      fusedOps++;
+    }
+  }
+
+  void getDependentDialects(mlir::DialectRegistry &registry) const override {
+    registry.insert<mlir::tt::ttir::TTIRDialect>();
+    registry.insert<mlir::tt::TTDialect>();
+  }
+};
+
 struct TTIRGenericOperandsToMemrefRewriter
     : public OpConversionPattern<GenericOp> {
   using OpConversionPattern<GenericOp>::OpConversionPattern;
@@ -759,6 +980,53 @@ class TTIRLayout : public impl::TTIRLayoutBase<TTIRLayout> {
 public:
   using impl::TTIRLayoutBase<TTIRLayout>::TTIRLayoutBase;
 
+  static bool isUsedAsDpsInit(Value value) {
+    return llvm::any_of(value.getUses(), [](OpOperand &use) {
+      auto dps = mlir::dyn_cast<DestinationStyleOpInterface>(use.getOwner());
+      return dps && dps.isDpsInit(&use);
+    });
+  }
+
+  // Operands are converted one use at a time, so a value read by several ops
+  // gets a conversion per reader. Keep the first conversion of every value to
+  // every layout and have later readers in the same block share it.
+  // Conversions written to as DPS outputs and conversions of values written
+  // to as DPS outputs are left alone, sharing them would alias buffers which
+  // get overwritten.
+  //
+  int64_t deduplicateToLayoutOps() {
+    int64_t numDeduplicated = 0;
+    getOperation()->walk([&](Block *block) {
+      llvm::DenseMap<std::pair<Value, Attribute>, ToLayoutOp> conversions;
+      for (Operation &op : llvm::make_early_inc_range(*block)) {
+        ToLayoutOp toLayout = mlir::dyn_cast<ToLayoutOp>(op);
+        if (!toLayout || isUsedAsDpsInit(toLayout.getResult()) ||
+            isUsedAsDpsInit(toLayout.getInput())) {
+          continue;
+        }
+
+        auto [conversion, inserted] = conversions.try_emplace(
+            {toLayout.getInput(),
+             mlir::cast<RankedTensorType>(toLayout.getResult().getType())
+                 .getEncoding()},
+            toLayout);
+        if (inserted) {
+          continue;
+        }
+
+        Value output = toLayout.getOutput();
+        toLayout.getResult().replaceAllUsesWith(
+            conversion->second.getResult());
+        toLayout->erase();
+        if (output.use_empty() && output.getDefiningOp<tensor::EmptyOp>()) {
+          output.getDefiningOp()->erase();
+        }
+        numDeduplicated++;
+      }
+    });
+    return numDeduplicated;
+  }
+
   void runOnOperation() final {
     {
       auto device = getCurrentScopeDevice(getOperation());
@@ -788,6 +1056,7 @@ public:
         return;
       }
     }
+    deduplicatedToLayouts += deduplicateToLayoutOps();
   }
 
   void getDependentDialects(mlir::DialectRegistry &registry) const override {
@@ -1086,7 +1355,12 @@ public:
 };
 
 class TTIRAllocate : public impl::TTIRAllocateBase<TTIRAllocate> {
-  struct SimpleAllocator {
+  // Best fit allocator over free address ranges of every memory space.
+  // Deallocated ranges are coalesced with free neighbours and reused by later
+  // allocations, so peak usage follows tensors live at the same time instead
+  // of all tensors of the func.
+  //
+  struct BestFitAllocator {
     struct MemorySpaceInfo {
       uint64_t baseAddress = 0;
       uint64_t size = 0;
@@ -1098,30 +1372,101 @@ class TTIRAllocate : public impl::TTIRAllocateBase<TTIRAllocate> {
       inline uint64_t end() const { return baseAddress + size; }
     };
 
-    SimpleAllocator(SmallVector<MemorySpaceInfo> memorySpaceInfo)
+    BestFitAllocator(SmallVector<MemorySpaceInfo> memorySpaceInfo)
         : memorySpaceInfo(memorySpaceInfo) {
-      currPtr.reserve(memorySpaceInfo.size());
-      for (auto const &info : memorySpaceInfo) {
-        currPtr.push_back(info.baseAddress);
+      freeRanges.resize(memorySpaceInfo.size());
+      peakAddress.reserve(memorySpaceInfo.size());
+      for (size_t i = 0; i < memorySpaceInfo.size(); ++i) {
+        if (memorySpaceInfo[i].size > 0) {
+          freeRanges[i][memorySpaceInfo[i].baseAddress] =
+              memorySpaceInfo[i].size;
+        }
+        peakAddress.push_back(memorySpaceInfo[i].baseAddress);
       }
     }
 
-    uint64_t allocate(uint64_t size, MemorySpace memorySpace) {
+    // Address of the allocation, none if no free range of the memory space
+    // fits it.
+    //
+    std::optional<uint64_t> allocate(uint64_t size, MemorySpace memorySpace) {
       if (isSystemMemorySpace(memorySpace)) {
         return 0;
       }
 
+      // Smallest free range which fits the aligned allocation, lowest
+      // address among equally small ones.
+      //
+      auto index = ttmlir::utils::enum_as_int(memorySpace);
+      std::map<uint64_t, uint64_t> &ranges = freeRanges[index];
+      auto bestRange = ranges.end();
+      for (auto range = ranges.begin(); range != ranges.end(); ++range) {
+        uint64_t address = ttmlir::utils::alignUp(
+            range->first, memorySpaceInfo[index].alignment);
+        if (address + size > range->first + range->second) {
+          continue;
+        }
+
+        if (bestRange == ranges.end() || range->second < bestRange->second) {
+          bestRange = range;
+        }
+      }
+      if (bestRange == ranges.end()) {
+        return std::nullopt;
+      }
+
+      auto [rangeAddress, rangeSize] = *bestRange;
+      uint64_t rangeEnd = rangeAddress + rangeSize;
+      uint64_t address = ttmlir::utils::alignUp(
+          rangeAddress, memorySpaceInfo[index].alignment);
+      ranges.erase(bestRange);
+      if (address > rangeAddress) {
+        ranges[rangeAddress] = address - rangeAddress;
+      }
+      if (address + size < rangeEnd) {
+        ranges[address + size] = rangeEnd - (address + size);
+      }
+
+      peakAddress[index] = std::max(peakAddress[index], address + size);
+      return address;
+    }
+
+    void deallocate(uint64_t address, uint64_t size, MemorySpace memorySpace) {
+      if (isSystemMemorySpace(memorySpace) || size == 0) {
+        return;
+      }
+
+      auto index = ttmlir::utils::enum_as_int(memorySpace);
+      std::map<uint64_t, uint64_t> &ranges = freeRanges[index];
+      auto range = ranges.emplace(address, size).first;
+
+      auto next = std::next(range);
+      if (next != ranges.end() && address + range->second == next->first) {
+        range->second += next->second;
+        ranges.erase(next);
+      }
+
+      if (range != ranges.begin()) {
+        auto prev = std::prev(range);
+        if (prev->first + prev->second == address) {
+          prev->second += range->second;
+          ranges.erase(range);
+        }
+      }
+    }
+
+    // Bytes from the base address up to the end of the highest allocation.
+    //
+    uint64_t getPeakUsage(MemorySpace memorySpace) const {
       auto index = ttmlir::utils::enum_as_int(memorySpace);
-      uint64_t &ptr = currPtr[index];
-      ptr = ttmlir::utils::alignUp(ptr, memorySpaceInfo[index].alignment);
-      auto result = ptr;
-      ptr += size;
-      assert(ptr <= memorySpaceInfo[index].end() && "Out of memory");
-      return result;
+      return peakAddress[index] - memorySpaceInfo[index].baseAddress;
     }
 
-    SmallVector<uint64_t> currPtr;
     SmallVector<MemorySpaceInfo> memorySpaceInfo;
+
+    // Free address ranges of every memory space, start address to size.
+    //
+    SmallVector<std::map<uint64_t, uint64_t>> freeRanges;
+    SmallVector<uint64_t> peakAddress;
   };
 
 public:
@@ -1152,20 +1497,30 @@ public:
     return std::make_pair(startOp, endOp);
   }
 
-  SimpleAllocator createSimpleAllocator(ChipDescAttr chipDesc) {
-    SmallVector<SimpleAllocator::MemorySpaceInfo> memorySpaceInfo;
+  BestFitAllocator createAllocator(ChipDescAttr chipDesc) {
+    SmallVector<BestFitAllocator::MemorySpaceInfo> memorySpaceInfo;
     memorySpaceInfo.resize(getMaxEnumValForMemorySpace() + 1llu);
     memorySpaceInfo[ttmlir::utils::enum_as_int(MemorySpace::DeviceL1)] =
-        SimpleAllocator::MemorySpaceInfo(chipDesc.getL1UnreservedBase(),
-                                         chipDesc.getL1Size(),
-                                         chipDesc.getNocL1AddressAlignBytes());
+        BestFitAllocator::MemorySpaceInfo(chipDesc.getL1UnreservedBase(),
+                                          chipDesc.getL1Size(),
+                                          chipDesc.getNocL1AddressAlignBytes());
     memorySpaceInfo[ttmlir::utils::enum_as_int(MemorySpace::DeviceDRAM)] =
-        SimpleAllocator::MemorySpaceInfo(
+        BestFitAllocator::MemorySpaceInfo(
             chipDesc.getDramUnreservedBase(), chipDesc.getDramChannelSize(),
             chipDesc.getNocDRAMAddressAlignBytes());
-    return SimpleAllocator(memorySpaceInfo);
+    return BestFitAllocator(memorySpaceInfo);
   }
 
+  // Tensor allocated for an empty op, live from startOp until endOp.
+  //
+  struct Allocation {
+    tensor::EmptyOp empty;
+    Operation *startOp;
+    Operation *endOp;
+    uint64_t address = 0;
+    uint64_t sizeBytes = 0;
+  };
+
   void runOnOperation() final {
     ModuleOp module = getOperation();
     IRRewriter rewriter(&getContext());
@@ -1173,13 +1528,13 @@ public:
     SystemDescAttr systemDesc = getCurrentScopeSystemDesc(module);
     ChipDescAttr chipDesc = systemDesc.getChipDescs().front();
 
-    module->walk([&](func::FuncOp func) {
+    WalkResult walkResult = module->walk([&](func::FuncOp func) {
       assert(func.getBody().hasOneBlock());
       auto systemDesc = getCurrentScopeSystemDesc(func);
       assert(systemDesc);
       auto device = getCurrentScopeDevice(func);
       assert(device);
-      SimpleAllocator allocator = createSimpleAllocator(chipDesc);
+      BestFitAllocator allocator = createAllocator(chipDesc);
       Liveness liveness(func.getOperation());
       const LivenessBlockInfo *livenessInfo =
           liveness.getLiveness(&func.getBody().front());
@@ -1190,38 +1545,103 @@ public:
         assert(operandTy.getEncoding());
         auto memorySpace = getMemorySpace(operandTy);
         auto sizeBytes = device.getTensorSizeBytes(operandTy, memorySpace);
-        auto address = allocator.allocate(sizeBytes, memorySpace);
+        std::optional<uint64_t> address =
+            allocator.allocate(sizeBytes, memorySpace);
+        if (!address) {
+          func.emitOpError()
+              << "failed to allocate argument " << operand.getArgNumber()
+              << " of " << sizeBytes << " bytes in "
+              << stringifyMemorySpace(memorySpace) << " memory";
+          return WalkResult::interrupt();
+        }
         argumentAllocations.push_back(rewriter.getAttr<ArgumentAllocationAttr>(
-            address, sizeBytes, memorySpace));
+            *address, sizeBytes, memorySpace));
       }
       func->setDiscardableAttr(ArgumentAllocationAttr::name,
                                rewriter.getArrayAttr(argumentAllocations));
 
+      // Allocate in program order. Tensors are allocated at their first use
+      // and freed after their last one, so a tensor only reuses memory of
+      // tensors which are dead before it becomes live.
+      //
+      std::vector<Allocation> allocations;
+      llvm::DenseMap<Operation *, SmallVector<size_t>> startingAt;
+      llvm::DenseMap<Operation *, SmallVector<size_t>> endingAt;
       func->walk([&](tensor::EmptyOp empty) {
-        auto resultTy =
-            mlir::cast<RankedTensorType>(empty.getResult().getType());
-        assert(resultTy.getEncoding());
-
+        assert(mlir::cast<RankedTensorType>(empty.getResult().getType())
+                   .getEncoding());
         auto [startOp, endOp] =
             getStartEndOperationThroughDPSOps(livenessInfo, empty.getResult());
+        startingAt[startOp].push_back(allocations.size());
+        endingAt[endOp].push_back(allocations.size());
+        allocations.push_back(Allocation{empty, startOp, endOp});
+      });
+
+      for (Operation &op : func.getBody().front()) {
+        for (size_t i : startingAt.lookup(&op)) {
+          Allocation &allocation = allocations[i];
+          auto resultTy = mlir::cast<RankedTensorType>(
+              allocation.empty.getResult().getType());
+          auto memorySpace = getMemorySpace(resultTy);
+          allocation.sizeBytes =
+              device.getTensorSizeBytes(resultTy, memorySpace);
+          std::optional<uint64_t> address =
+              allocator.allocate(allocation.sizeBytes, memorySpace);
+          if (!address) {
+            allocation.empty->emitOpError()
+                << "failed to allocate " << allocation.sizeBytes
+                << " bytes in " << stringifyMemorySpace(memorySpace)
+                << " memory";
+            return WalkResult::interrupt();
+          }
+          allocation.address = *address;
+        }
+
+        // Returned tensors stay allocated.
+        //
+        if (isa<func::ReturnOp>(op)) {
+          continue;
+        }
+
+        for (size_t i : endingAt.lookup(&op)) {
+          const Allocation &allocation = allocations[i];
+          allocator.deallocate(
+              allocation.address, allocation.sizeBytes,
+              getMemorySpace(mlir::cast<RankedTensorType>(
+                  allocation.empty.getResult().getType())));
+        }
+      }
+
+      peakL1Usage.updateMax(allocator.getPeakUsage(MemorySpace::DeviceL1));
+      peakDRAMUsage.updateMax(
+          allocator.getPeakUsage(MemorySpace::DeviceDRAM));
 
+      for (const Allocation &allocation : allocations) {
         // Replace empty with allocate
+        auto resultTy = mlir::cast<RankedTensorType>(
+            allocation.empty.getResult().getType());
         auto memorySpace = getMemorySpace(resultTy);
-        auto sizeBytes = device.getTensorSizeBytes(resultTy, memorySpace);
-        auto address = allocator.allocate(sizeBytes, memorySpace);
-        rewriter.setInsertionPoint(startOp);
-        auto alloc = rewriter.create<AllocOp>(startOp->getLoc(), resultTy,
-                                              address, sizeBytes, memorySpace);
-        rewriter.replaceOp(empty, alloc);
+        rewriter.setInsertionPoint(allocation.startOp);
+        auto alloc = rewriter.create<AllocOp>(
+            allocation.startOp->getLoc(), resultTy, allocation.address,
+            allocation.sizeBytes, memorySpace);
+        rewriter.replaceOp(allocation.empty, alloc);
 
         // Insert deallocate unless this value is being returned
-        if (isa<func::ReturnOp>(endOp)) {
-          return;
+        if (isa<func::ReturnOp>(allocation.endOp)) {
+          continue;
         }
-        rewriter.setInsertionPointAfter(endOp);
-        rewriter.create<DeallocOp>(endOp->getLoc(), alloc.getResult());
-      });
+        rewriter.setInsertionPointAfter(allocation.endOp);
+        rewriter.create<DeallocOp>(allocation.endOp->getLoc(),
+                                   alloc.getResult());
+      }
+
+      return WalkResult::advance();
     });
+
+    if (walkResult.wasInterrupted()) {
+      signalPassFailure();
+    }
   }
 };
 
@@ -1248,37 +1668,203 @@ public:
     ChipDescAttr chipDesc = systemDesc.getChipDescs()[0];
     llvm::DenseMap<Operation *, std::vector<LayoutAttr>> legalLayouts;
 
+    // Tensor footprints are shared by all analyses below.
+    //
+    LayoutSizeCache layoutSizeCache;
+    AnalyticalOpCostModel costModel(
+        chipDesc,
+        mlir::cast<tt::DeviceAttr>(moduleOp->getAttr(tt::DeviceAttr::name)),
+        &layoutSizeCache);
+
+    // Structurally identical ops share legal layouts. Cache file is reused
+    // only by compilations for the same system desc and device.
+    //
+    LegalLayoutCache legalLayoutCache(
+        legalLayoutCacheFile.empty()
+            ? llvm::SmallString<32>()
+            : LegalLayoutCache::getFingerprint(
+                  systemDesc, mlir::cast<tt::DeviceAttr>(
+                                  moduleOp->getAttr(tt::DeviceAttr::name))));
+    if (!legalLayoutCacheFile.empty() &&
+        llvm::sys::fs::exists(legalLayoutCacheFile) &&
+        failed(legalLayoutCache.load(&getContext(), legalLayoutCacheFile))) {
+      moduleOp->emitWarning() << "Failed to load legal layout cache from "
+                              << legalLayoutCacheFile;
+    }
+
+    // Override keys are compiled once, not per op.
+    //
+    llvm::Expected<LayoutOverrideMatcher> overrideMatcher =
+        LayoutOverrideMatcher::create(overrideOutputLayout);
+    if (!overrideMatcher) {
+      moduleOp->emitError() << llvm::toString(overrideMatcher.takeError());
+      signalPassFailure();
+      return;
+    }
+
+    // Legal layouts of different ops are independent, generate them in
+    // parallel and merge in walk order. Analyses are created directly as
+    // child analysis lookup is not thread safe.
+    //
+    llvm::SmallVector<Operation *> analyzedOps;
     moduleOp->walk([&](Operation *op) {
-      if (op->getNumResults() == 0) {
-        return;
+      if (op->getNumResults() > 0) {
+        analyzedOps.push_back(op);
       }
+    });
 
+    std::vector<std::vector<LayoutAttr>> opLegalLayouts(analyzedOps.size());
+    mlir::parallelFor(&getContext(), 0, analyzedOps.size(), [&](size_t i) {
+      Operation *op = analyzedOps[i];
       RankedTensorType tensorType =
           mlir::cast<RankedTensorType>(op->getResult(0).getType());
-      LegalGridAnalysis legalGridAnalysis =
-          getChildAnalysis<LegalGridAnalysis>(op);
-      legalGridAnalysis.init(LegalGridAnalysisInput(
-          chipDesc, max_grid, tensorType, &overrideOutputLayout));
-      legalLayouts[op] = legalGridAnalysis.getResult();
+      LegalGridAnalysis legalGridAnalysis(op);
+      legalGridAnalysis.init(
+          LegalGridAnalysisInput(chipDesc, max_grid, tensorType,
+                                 &*overrideMatcher, &layoutSizeCache,
+                                 &legalLayoutCache, &costModel));
+      opLegalLayouts[i] = legalGridAnalysis.getResult();
     });
 
+    for (size_t i = 0; i < analyzedOps.size(); ++i) {
+      legalLayouts[analyzedOps[i]] = std::move(opLegalLayouts[i]);
+    }
+
+    legalLayoutCacheHits += legalLayoutCache.getNumHits();
+    legalLayoutCacheMisses += legalLayoutCache.getNumMisses();
+    if (!legalLayoutCacheFile.empty() &&
+        failed(legalLayoutCache.save(legalLayoutCacheFile))) {
+      moduleOp->emitWarning() << "Failed to save legal layout cache to "
+                              << legalLayoutCacheFile;
+    }
+
+    // Layouts picked by earlier compilations for the same system desc and
+    // device seed sharding and op config analyses.
+    //
+    TuningDatabase tuningDatabase(
+        tuningDatabaseImport.empty() && tuningDatabaseExport.empty()
+            ? llvm::SmallString<32>()
+            : LegalLayoutCache::getFingerprint(
+                  systemDesc, mlir::cast<tt::DeviceAttr>(
+                                  moduleOp->getAttr(tt::DeviceAttr::name))));
+    if (!tuningDatabaseImport.empty() &&
+        llvm::sys::fs::exists(tuningDatabaseImport) &&
+        failed(
+            tuningDatabase.import(moduleOp->getLoc(), tuningDatabaseImport))) {
+      moduleOp->emitWarning() << "Failed to import tuning database from "
+                              << tuningDatabaseImport;
+    }
+
+    OptimizerReportInput reportInput;
+    if (!optimizerReport.empty()) {
+      for (const auto &opLayouts : legalLayouts) {
+        reportInput.numLegalLayouts[opLayouts.first] = opLayouts.second.size();
+      }
+    }
+
     llvm::DenseMap<func::FuncOp, llvm::SmallVector<Operation *>> opSchedule;
     std::unordered_set<Edge> reshardedEdges;
+    std::vector<TensorSplitChain> tensorSplitChains;
     if (shardingPassEnabled) {
       // Perform sharding analysis.
       //
       ShardingAnalysis shardingAnalysis = getAnalysis<ShardingAnalysis>();
       shardingAnalysis.init(
-          ShardingAnalysisInput(legalLayouts, chipDesc.getUsableL1Size()));
+          ShardingAnalysisInput(legalLayouts, chipDesc.getUsableL1Size(),
+                                &layoutSizeCache, &costModel, shardingPolicy,
+                                &tuningDatabase, l1SpillEnabled));
       legalLayouts = shardingAnalysis.getResult().legalLayouts;
       opSchedule = shardingAnalysis.getResult().schedule;
       reshardedEdges = shardingAnalysis.getResult().reshardedEdges;
+      tensorSplitChains = shardingAnalysis.getResult().tensorSplitChains;
+      streamedShardChains += tensorSplitChains.size();
+      reportInput.shardChainConfigs =
+          shardingAnalysis.getResult().shardChainConfigs;
     }
 
     // Pick optimal op configuration.
     //
     OpConfigAnalysis opConfigAnalysis = getAnalysis<OpConfigAnalysis>();
-    opConfigAnalysis.init(OpConfigAnalysisInput(std::move(legalLayouts)));
+    opConfigAnalysis.init(OpConfigAnalysisInput(std::move(legalLayouts),
+                                                &costModel, &tuningDatabase));
+
+    if (!tuningDatabaseImport.empty() || !tuningDatabaseExport.empty()) {
+      for (const auto &opLayout : opConfigAnalysis.getResult()) {
+        // Only imported records seed layouts, records of structurally
+        // identical ops recorded below don't.
+        //
+        std::optional<TuningRecord> tuned =
+            tuningDatabase.lookupImported(opLayout.first);
+        if (tuned && tuned->layout == opLayout.second) {
+          tuningDatabaseSeededOps++;
+        }
+
+        tuningDatabase.record(
+            opLayout.first, opLayout.second,
+            costModel.getOpCost(opLayout.first, opLayout.second));
+      }
+    }
+
+    if (!tuningDatabaseExport.empty() &&
+        failed(tuningDatabase.exportTo(tuningDatabaseExport))) {
+      moduleOp->emitWarning() << "Failed to export tuning database to "
+                              << tuningDatabaseExport;
+    }
+
+    if (memoryAwareScheduling) {
+      // Reorder ops to lower peak L1 usage of picked layouts.
+      //
+      MemoryScheduleAnalysis memoryScheduleAnalysis =
+          getAnalysis<MemoryScheduleAnalysis>();
+      memoryScheduleAnalysis.init(MemoryScheduleAnalysisInput(
+          opSchedule, opConfigAnalysis.getResult(), chipDesc.getUsableL1Size(),
+          &layoutSizeCache));
+      opSchedule = memoryScheduleAnalysis.getResult().schedule;
+      peakL1UsageBefore = memoryScheduleAnalysis.getResult().peakL1UsageBefore;
+      peakL1UsageAfter = memoryScheduleAnalysis.getResult().peakL1UsageAfter;
+    }
+
+    std::vector<L1Spill> l1SpillPlan;
+    if (l1SpillEnabled) {
+      // Plan spills on the final schedule and layouts. Ops of streamed chains
+      // are rewritten slice by slice and are left alone.
+      //
+      llvm::DenseSet<Operation *> fixedOps;
+      for (const TensorSplitChain &splitChain : tensorSplitChains) {
+        fixedOps.insert(splitChain.ops.begin(), splitChain.ops.end());
+      }
+
+      L1SpillAnalysis l1SpillAnalysis = getAnalysis<L1SpillAnalysis>();
+      l1SpillAnalysis.init(L1SpillAnalysisInput(
+          opSchedule, opConfigAnalysis.getResult(), chipDesc.getUsableL1Size(),
+          &layoutSizeCache, fixedOps));
+      l1SpillPlan = l1SpillAnalysis.getResult().spills;
+
+      // Layouts picked after subgraphs were built may not fit even with
+      // spills, such ops need a smaller layout or a DRAM operand.
+      //
+      for (Operation *op : l1SpillAnalysis.getResult().overSubscribedOps) {
+        op->emitRemark() << "live L1 tensors exceed usable L1 of "
+                         << chipDesc.getUsableL1Size()
+                         << " bytes even with spills";
+        l1OverSubscribedOps++;
+      }
+    }
+
+    // Report decisions before they are applied, ops are still in their
+    // picked layouts and resharded edges are not materialized yet.
+    //
+    if (!optimizerReport.empty()) {
+      reportInput.schedule = opSchedule;
+      reportInput.reshardedEdges = reshardedEdges;
+      reportInput.opLayouts = opConfigAnalysis.getResult();
+      if (failed(OptimizerReport::write(
+              OptimizerReport::build(moduleOp, reportInput, &layoutSizeCache),
+              optimizerReport))) {
+        moduleOp->emitWarning()
+            << "Failed to write optimizer report to " << optimizerReport;
+      }
+    }
 
     // Pure application of determined grid sizes to the operations.
     // No further analysis.
@@ -1305,11 +1891,6 @@ public:
 
       func->walk([&](Operation *op) {
         if (op->getNumResults() == 0) {
-          func::ReturnOp funcReturn = dyn_cast<func::ReturnOp>(op);
-          if (funcReturn) {
-            funcResultTypes.append(funcReturn.getOperandTypes().begin(),
-                                   funcReturn.getOperandTypes().end());
-          }
           return;
         }
 
@@ -1334,23 +1915,323 @@ public:
       });
 
       if (reshardingEnabled) {
-        processReshardedEdges(reshardedEdges);
+        processReshardedEdges(reshardedEdges, &layoutSizeCache);
       }
 
+      processTensorSplitChains(func, tensorSplitChains);
+
+      processL1Spills(func, l1SpillPlan);
+
       // Update the function type to reflect the updated return operation's
       // result types.
       //
+      func->walk([&](func::ReturnOp funcReturn) {
+        funcResultTypes.append(funcReturn.getOperandTypes().begin(),
+                               funcReturn.getOperandTypes().end());
+      });
       FunctionType funcType = func.getFunctionType();
       FunctionType newFuncType = FunctionType::get(
           func.getContext(), funcType.getInputs(), funcResultTypes);
       func.setType(newFuncType);
     });
+
+    layoutSizeCacheHits += layoutSizeCache.getNumHits();
+    layoutSizeCacheMisses += layoutSizeCache.getNumMisses();
+  }
+
+  // Streams every tensor split chain of the func slice by slice. Split inputs
+  // of the chain are sliced along the outer dim, chain ops are cloned for
+  // every slice on slice sized tensors and output slices of the last op are
+  // concatenated in DRAM. TTNN has no loops, so the slice loop is unrolled.
+  //
+  void
+  processTensorSplitChains(func::FuncOp func,
+                           const std::vector<TensorSplitChain> &splitChains) {
+    for (const TensorSplitChain &splitChain : splitChains) {
+      Operation *lastOp = splitChain.ops.back();
+      if (lastOp->getParentOfType<func::FuncOp>() != func) {
+        continue;
+      }
+
+      unsigned splitFactor = splitChain.splitFactor;
+      llvm::SmallPtrSet<Operation *, 8> chainOps(splitChain.ops.begin(),
+                                                 splitChain.ops.end());
+      OpBuilder builder(lastOp);
+
+      // Chain input resharded to L1 would not fit whole, keep it in DRAM and
+      // reshard every slice instead.
+      //
+      for (Operation *op : splitChain.ops) {
+        for (Value operand : op->getOperands()) {
+          auto toLayoutOp = operand.getDefiningOp<ttir::ToLayoutOp>();
+          if (toLayoutOp && !isChainValue(toLayoutOp.getInput(), chainOps) &&
+              getLayout(toLayoutOp.getResult())
+                  .hasShardedL1TensorMemoryLayout()) {
+            moveToDRAM(toLayoutOp);
+          }
+        }
+      }
+
+      SmallVector<Value> outputSlices;
+      for (unsigned sliceIndex = 0; sliceIndex < splitFactor; ++sliceIndex) {
+        IRMapping mapping;
+        for (Operation *op : splitChain.ops) {
+          auto dpsOp = llvm::cast<DestinationStyleOpInterface>(op);
+          for (OpOperand &operand : op->getOpOperands()) {
+            Value value = operand.get();
+            if (mapping.contains(value) || isChainValue(value, chainOps)) {
+              continue;
+            }
+
+            if (dpsOp.isDpsInit(&operand)) {
+              RankedTensorType splitType =
+                  getSplitType(op->getResult(0), splitFactor);
+              mapping.map(value,
+                          builder.create<tensor::EmptyOp>(
+                              op->getLoc(), splitType.getShape(),
+                              splitType.getElementType(),
+                              splitType.getEncoding()));
+              continue;
+            }
+
+            auto toLayoutOp = value.getDefiningOp<ttir::ToLayoutOp>();
+            if (toLayoutOp && isChainValue(toLayoutOp.getInput(), chainOps)) {
+              // Reshard between chain ops, reshard the slice instead.
+              //
+              mapping.map(value,
+                          createToLayout(builder, toLayoutOp,
+                                         mapping.lookup(toLayoutOp.getInput()),
+                                         splitFactor));
+            } else if (toLayoutOp &&
+                       isSplitOperand(op, operand.getOperandNumber())) {
+              Value slice = createSlice(builder, toLayoutOp.getResult(),
+                                        splitFactor, sliceIndex);
+              mapping.map(value, createToLayout(builder, toLayoutOp, slice,
+                                                splitFactor));
+            } else if (isSplitOperand(op, operand.getOperandNumber())) {
+              mapping.map(value,
+                          createSlice(builder, value, splitFactor, sliceIndex));
+            }
+          }
+
+          Operation *clonedOp = builder.clone(*op, mapping);
+          clonedOp->getResult(0).setType(
+              getSplitType(op->getResult(0), splitFactor));
+        }
+
+        outputSlices.push_back(mapping.lookup(lastOp->getResult(0)));
+      }
+
+      // Concatenate output slices in DRAM.
+      //
+      RankedTensorType outputType =
+          mlir::cast<RankedTensorType>(lastOp->getResult(0).getType());
+      RankedTensorType concatType = RankedTensorType::get(
+          outputType.getShape(), outputType.getElementType(),
+          getDRAMLayout(lastOp->getResult(0)));
+      tensor::EmptyOp concatEmptyOp = builder.create<tensor::EmptyOp>(
+          lastOp->getLoc(), concatType.getShape(), concatType.getElementType(),
+          concatType.getEncoding());
+      ttir::ConcatOp concatOp = builder.create<ttir::ConcatOp>(
+          lastOp->getLoc(), concatType, outputSlices, concatEmptyOp,
+          builder.getSI32IntegerAttr(0),
+          getAnyDeviceTileConstraints(builder, splitFactor + 1));
+      lastOp->getResult(0).replaceAllUsesWith(concatOp.getResult());
+
+      for (Operation *op : llvm::reverse(splitChain.ops)) {
+        eraseWithDeadOperands(op);
+      }
+    }
+  }
+
+  // Moves every spilled tensor to DRAM after the op its spill follows and
+  // back to its L1 layout before its first user after that. Later spills of
+  // the same tensor spill its refill.
+  //
+  void processL1Spills(func::FuncOp func, const std::vector<L1Spill> &spills) {
+    llvm::DenseMap<Operation *, Value> l1Values;
+    for (const L1Spill &spill : spills) {
+      if (spill.op->getParentOfType<func::FuncOp>() != func) {
+        continue;
+      }
+
+      Value &l1Value =
+          l1Values.try_emplace(spill.op, spill.op->getResult(0)).first->second;
+
+      SmallVector<OpOperand *> lateUses;
+      Operation *firstLateUser = nullptr;
+      for (OpOperand &use : l1Value.getUses()) {
+        Operation *user = use.getOwner();
+        if (!spill.spillAfterOp->isBeforeInBlock(user)) {
+          continue;
+        }
+
+        lateUses.push_back(&use);
+        if (!firstLateUser || user->isBeforeInBlock(firstLateUser)) {
+          firstLateUser = user;
+        }
+      }
+
+      if (lateUses.empty()) {
+        continue;
+      }
+
+      OpBuilder builder(spill.spillAfterOp->getContext());
+      builder.setInsertionPointAfter(spill.spillAfterOp);
+      Value spilled = createToLayout(builder, l1Value, getDRAMLayout(l1Value));
+      builder.setInsertionPoint(firstLateUser);
+      Value refilled = createToLayout(builder, spilled, getLayout(l1Value));
+      for (OpOperand *use : lateUses) {
+        use->set(refilled);
+      }
+
+      l1Value = refilled;
+      l1Spills++;
+    }
+  }
+
+  static bool isChainValue(Value value,
+                           const llvm::SmallPtrSet<Operation *, 8> &chainOps) {
+    return value.getDefiningOp() && chainOps.contains(value.getDefiningOp());
+  }
+
+  static LayoutAttr getLayout(Value value) {
+    return mlir::cast<LayoutAttr>(
+        mlir::cast<RankedTensorType>(value.getType()).getEncoding());
+  }
+
+  static LayoutAttr getDRAMLayout(Value value) {
+    RankedTensorType tensorType = mlir::cast<RankedTensorType>(value.getType());
+    MLIRContext *context = value.getContext();
+    return getLayout(value)
+        .withMemorySpace(context, MemorySpace::DeviceDRAM)
+        .withMemoryLayout(context, TensorMemoryLayout::Interleaved)
+        .withGrid(context, tensorType,
+                  getCurrentScopeDevice(value.getParentBlock()->getParentOp())
+                      .getWorkerGrid());
   }
 
-  void processReshardedEdges(const std::unordered_set<Edge> &reshardedEdges) {
+  static RankedTensorType getSplitType(Value value, unsigned splitFactor) {
+    RankedTensorType tensorType = mlir::cast<RankedTensorType>(value.getType());
+    return RankedTensorType::get(
+        getSplitShape(tensorType.getShape(), splitFactor),
+        tensorType.getElementType(),
+        getSplitLayout(value.getContext(), tensorType.getShape(),
+                       getLayout(value), splitFactor));
+  }
+
+  static ArrayAttr getAnyDeviceTileConstraints(OpBuilder &builder,
+                                               unsigned numOperands) {
+    Attribute anyDeviceTile = builder.getAttr<OperandConstraintAttr>(
+        OperandConstraint::AnyDeviceTile);
+    return builder.getArrayAttr(
+        SmallVector<Attribute>(numOperands, anyDeviceTile));
+  }
+
+  static void moveToDRAM(ttir::ToLayoutOp toLayoutOp) {
+    RankedTensorType tensorType = toLayoutOp.getResult().getType();
+    RankedTensorType newTensorType = RankedTensorType::get(
+        tensorType.getShape(), tensorType.getElementType(),
+        getDRAMLayout(toLayoutOp.getResult()));
+    toLayoutOp.getResult().setType(newTensorType);
+    toLayoutOp.getOutput().setType(newTensorType);
+  }
+
+  // Slice sliceIndex of splitFactor slices of the value along the outer dim.
+  //
+  static Value createSlice(OpBuilder &builder, Value value,
+                           unsigned splitFactor, unsigned sliceIndex) {
+    RankedTensorType tensorType = mlir::cast<RankedTensorType>(value.getType());
+    RankedTensorType splitType = getSplitType(value, splitFactor);
+    int64_t rank = tensorType.getRank();
+
+    SmallVector<int32_t> begins(rank, 0);
+    SmallVector<int32_t> ends(tensorType.getShape());
+    SmallVector<int32_t> step(rank, 1);
+    begins[0] = sliceIndex * splitType.getDimSize(0);
+    ends[0] = (sliceIndex + 1) * splitType.getDimSize(0);
+
+    tensor::EmptyOp emptyOp = builder.create<tensor::EmptyOp>(
+        value.getLoc(), splitType.getShape(), splitType.getElementType(),
+        splitType.getEncoding());
+    return builder.create<ttir::SliceOp>(
+        value.getLoc(), splitType, value, emptyOp,
+        builder.getI32ArrayAttr(begins), builder.getI32ArrayAttr(ends),
+        builder.getI32ArrayAttr(step), getAnyDeviceTileConstraints(builder, 2));
+  }
+
+  // Reshards slice to the slice of the layout toLayoutOp reshards to.
+  //
+  static Value createToLayout(OpBuilder &builder, ttir::ToLayoutOp toLayoutOp,
+                              Value slice, unsigned splitFactor) {
+    RankedTensorType splitType =
+        getSplitType(toLayoutOp.getOutput(), splitFactor);
+    tensor::EmptyOp emptyOp = builder.create<tensor::EmptyOp>(
+        toLayoutOp.getLoc(), splitType.getShape(), splitType.getElementType(),
+        splitType.getEncoding());
+    return builder.create<ttir::ToLayoutOp>(toLayoutOp.getLoc(), splitType,
+                                            slice, emptyOp);
+  }
+
+  // Moves value to the layout.
+  //
+  static Value createToLayout(OpBuilder &builder, Value value,
+                              LayoutAttr layout) {
+    RankedTensorType tensorType = mlir::cast<RankedTensorType>(value.getType());
+    RankedTensorType newTensorType = RankedTensorType::get(
+        tensorType.getShape(), tensorType.getElementType(), layout);
+    tensor::EmptyOp emptyOp = builder.create<tensor::EmptyOp>(
+        value.getLoc(), newTensorType.getShape(),
+        newTensorType.getElementType(), layout);
+    return builder.create<ttir::ToLayoutOp>(value.getLoc(), newTensorType,
+                                            value, emptyOp);
+  }
+
+  // Erases op and then its operand producers which are left without users,
+  // if they are empty tensors or reshards.
+  //
+  static void eraseWithDeadOperands(Operation *op) {
+    SmallVector<Operation *> operandOps;
+    for (Value operand : op->getOperands()) {
+      if (Operation *operandOp = operand.getDefiningOp()) {
+        operandOps.push_back(operandOp);
+      }
+    }
+
+    op->erase();
+    for (Operation *operandOp : operandOps) {
+      if (operandOp->use_empty() &&
+          llvm::isa<tensor::EmptyOp, ttir::ToLayoutOp>(operandOp)) {
+        eraseWithDeadOperands(operandOp);
+      }
+    }
+  }
+
+  void processReshardedEdges(const std::unordered_set<Edge> &reshardedEdges,
+                             LayoutSizeCache *layoutSizeCache) {
+    // Reshards of the same producer value to the same layout, shared by all
+    // consumers which need it.
+    //
+    llvm::MapVector<std::pair<Value, LayoutAttr>, SmallVector<Edge>> reshards;
+
+    // Visit edges in program order of their consumers, so reshards are
+    // created in the same order on every run instead of in hash order.
+    //
+    llvm::DenseMap<Operation *, size_t> opOrder;
+    getOperation()->walk([&](Operation *op) {
+      size_t index = opOrder.size();
+      opOrder[op] = index;
+    });
+    SmallVector<Edge> sortedEdges(reshardedEdges.begin(),
+                                  reshardedEdges.end());
+    llvm::sort(sortedEdges, [&](const Edge &a, const Edge &b) {
+      return std::make_pair(opOrder.lookup(a.consumerOp), a.operandIndex) <
+             std::make_pair(opOrder.lookup(b.consumerOp), b.operandIndex);
+    });
+
     // Insert reshard ops here based on results of sharding analysis.
     //
-    for (const Edge &edge : reshardedEdges) {
+    for (const Edge &edge : sortedEdges) {
       Operation *producerOp = edge.producerOp;
       Operation *consumerOp = edge.consumerOp;
 
@@ -1385,7 +2266,8 @@ public:
                 .withMemoryLayout(toLayoutOp.getContext(),
                                   consumerOpOutputLayout.getMemLayout())
                 .withGrid(toLayoutOp.getContext(), toLayoutOpTensorType,
-                          consumerOpOutputLayout.getGrid()));
+                          consumerOpOutputLayout.getGrid())
+                .withTileAlignedShardShape(toLayoutOp.getContext()));
 
         toLayoutOp.getResult().setType(newTensorType);
         toLayoutOp.getOperands().back().setType(newTensorType);
@@ -1396,8 +2278,6 @@ public:
 
         RankedTensorType producerOpTensorType =
             mlir::cast<RankedTensorType>(producerOp->getResult(0).getType());
-        llvm::ArrayRef<int64_t> producerOpTensorShape =
-            producerOpTensorType.getShape();
         LayoutAttr producerOpLayout =
             mlir::cast<LayoutAttr>(producerOpTensorType.getEncoding());
 
@@ -1405,8 +2285,7 @@ public:
         // actually needs to be properly resolved based on op type, output
         // layout and other inputs.
         //
-        RankedTensorType newTensorType = RankedTensorType::get(
-            producerOpTensorShape, producerOpTensorType.getElementType(),
+        LayoutAttr reshardLayout =
             producerOpLayout
                 .withElementType(consumerOp->getContext(),
                                  consumerOpOutputLayout.getElementType())
@@ -1415,22 +2294,280 @@ public:
                 .withMemoryLayout(consumerOp->getContext(),
                                   consumerOpOutputLayout.getMemLayout())
                 .withGrid(consumerOp->getContext(), producerOpTensorType,
-                          consumerOpOutputLayout.getGrid()));
+                          consumerOpOutputLayout.getGrid())
+                .withTileAlignedShardShape(consumerOp->getContext());
+
+        reshards[{producerOp->getResult(0), reshardLayout}].push_back(edge);
+      }
+    }
+
+    for (auto &[reshard, edges] : reshards) {
+      auto [producerValue, reshardLayout] = reshard;
+      RankedTensorType producerOpTensorType =
+          mlir::cast<RankedTensorType>(producerValue.getType());
+      llvm::ArrayRef<int64_t> producerOpTensorShape =
+          producerOpTensorType.getShape();
+      RankedTensorType newTensorType = RankedTensorType::get(
+          producerOpTensorShape, producerOpTensorType.getElementType(),
+          reshardLayout);
+
+      // Shared reshard has to dominate all of its consumers.
+      //
+      Operation *firstConsumerOp = edges.front().consumerOp;
+      for (const Edge &edge : edges) {
+        if (edge.consumerOp->isBeforeInBlock(firstConsumerOp)) {
+          firstConsumerOp = edge.consumerOp;
+        }
+      }
+
+      OpBuilder builder(firstConsumerOp);
+
+      mlir::tensor::EmptyOp emptyOp = builder.create<tensor::EmptyOp>(
+          firstConsumerOp->getLoc(), producerOpTensorShape,
+          producerOpTensorType.getElementType(), reshardLayout);
+
+      Operation *toLayoutOp = builder.create<ttir::ToLayoutOp>(
+          firstConsumerOp->getLoc(), newTensorType, producerValue, emptyOp);
+
+      for (const Edge &edge : edges) {
+        edge.consumerOp->setOperand(edge.operandIndex,
+                                    toLayoutOp->getResult(0));
+      }
+
+      if (edges.size() > 1) {
+        DeviceAttr device = getCurrentScopeDevice(firstConsumerOp);
+        reshardBytesSaved +=
+            (edges.size() - 1) *
+            layoutSizeCache->getLayoutSizeBytes(device, producerOpTensorShape,
+                                                reshardLayout,
+                                                reshardLayout.getMemorySpace());
+      }
+    }
+  }
+};
+
+class TTIRValidateMemoryPlan
+    : public impl::TTIRValidateMemoryPlanBase<TTIRValidateMemoryPlan> {
+  // Buffer of a tensor live at an op. Address is known if the buffer was
+  // allocated by ttir-allocate.
+  //
+  struct LiveBuffer {
+    Value value;
+    uint64_t sizeBytes;
+    std::optional<uint64_t> address;
+  };
+
+public:
+  using impl::TTIRValidateMemoryPlanBase<
+      TTIRValidateMemoryPlan>::TTIRValidateMemoryPlanBase;
+
+  // Outputs of DPS ops live in the buffer of their init operand.
+  //
+  static Value getBuffer(Value value) {
+    while (OpResult result = mlir::dyn_cast<OpResult>(value)) {
+      auto dpsOp = llvm::dyn_cast<DestinationStyleOpInterface>(
+          result.getOwner());
+      if (!dpsOp) {
+        break;
+      }
+      value = dpsOp.getTiedOpOperand(result)->get();
+    }
+    return value;
+  }
 
-        OpBuilder builder(consumerOp);
+  // Buffers in order of definition, func arguments first.
+  //
+  static bool isDefinedBefore(Value a, Value b) {
+    BlockArgument argA = mlir::dyn_cast<BlockArgument>(a);
+    BlockArgument argB = mlir::dyn_cast<BlockArgument>(b);
+    if (argA || argB) {
+      return argA && (!argB || argA.getArgNumber() < argB.getArgNumber());
+    }
 
-        mlir::tensor::EmptyOp emptyOp = builder.create<tensor::EmptyOp>(
-            consumerOp->getLoc(), producerOpTensorShape,
-            producerOpTensorType.getElementType(),
-            mlir::cast<LayoutAttr>(newTensorType.getEncoding()));
+    if (a.getDefiningOp() != b.getDefiningOp()) {
+      return a.getDefiningOp()->isBeforeInBlock(b.getDefiningOp());
+    }
+    return mlir::cast<OpResult>(a).getResultNumber() <
+           mlir::cast<OpResult>(b).getResultNumber();
+  }
 
-        Operation *toLayoutOp = builder.create<ttir::ToLayoutOp>(
-            consumerOp->getLoc(), newTensorType, producerOp->getResult(0),
-            emptyOp);
+  static std::optional<LiveBuffer> getLiveBuffer(Value buffer,
+                                                 MemorySpace memorySpace,
+                                                 func::FuncOp func,
+                                                 DeviceAttr device) {
+    if (AllocOp alloc = buffer.getDefiningOp<AllocOp>()) {
+      if (alloc.getMemorySpace() != memorySpace) {
+        return std::nullopt;
+      }
+      return LiveBuffer{buffer, alloc.getSize(), alloc.getAddress()};
+    }
 
-        consumerOp->setOperand(edge.operandIndex, toLayoutOp->getResult(0));
+    if (BlockArgument arg = mlir::dyn_cast<BlockArgument>(buffer)) {
+      ArrayAttr argumentAllocations =
+          func->getAttrOfType<ArrayAttr>(ArgumentAllocationAttr::name);
+      if (argumentAllocations &&
+          arg.getArgNumber() < argumentAllocations.size()) {
+        auto allocation = mlir::cast<ArgumentAllocationAttr>(
+            argumentAllocations[arg.getArgNumber()]);
+        if (allocation.getMemorySpace() != memorySpace) {
+          return std::nullopt;
+        }
+        return LiveBuffer{buffer, allocation.getSize(),
+                          allocation.getAddress()};
       }
     }
+
+    RankedTensorType tensorType =
+        mlir::dyn_cast<RankedTensorType>(buffer.getType());
+    if (!tensorType ||
+        !mlir::isa_and_nonnull<LayoutAttr>(tensorType.getEncoding()) ||
+        getMemorySpace(tensorType) != memorySpace) {
+      return std::nullopt;
+    }
+    return LiveBuffer{buffer,
+                      device.getTensorSizeBytes(tensorType, memorySpace),
+                      std::nullopt};
+  }
+
+  // L1 used by circular buffers and program of the op.
+  //
+  static uint64_t getOpCBUsage(Operation *op) {
+    if (op->getNumResults() == 0 || isa<AllocOp>(op)) {
+      return 0;
+    }
+
+    RankedTensorType tensorType =
+        mlir::dyn_cast<RankedTensorType>(op->getResult(0).getType());
+    if (!tensorType) {
+      return 0;
+    }
+
+    LayoutAttr layout =
+        mlir::dyn_cast_or_null<LayoutAttr>(tensorType.getEncoding());
+    return layout ? getOpL1ExecUsage(op, layout) : 0;
+  }
+
+  void runOnOperation() final {
+    ModuleOp module = getOperation();
+    ChipDescAttr chipDesc =
+        getCurrentScopeSystemDesc(module).getChipDescs().front();
+
+    struct MemorySpaceCapacity {
+      MemorySpace memorySpace;
+      uint64_t baseAddress;
+      uint64_t size;
+    };
+    MemorySpaceCapacity capacities[] = {
+        {MemorySpace::DeviceL1, chipDesc.getL1UnreservedBase(),
+         chipDesc.getUsableL1Size()},
+        {MemorySpace::DeviceDRAM, chipDesc.getDramUnreservedBase(),
+         chipDesc.getUsableDramChannelSize()}};
+
+    std::string csv;
+    llvm::raw_string_ostream csvStream(csv);
+    csvStream << "func,step,op,memory_space,tensor_bytes,cb_bytes,total_bytes,"
+                 "capacity_bytes,live_tensors\n";
+
+    bool overCapacity = false;
+    module->walk([&](func::FuncOp func) {
+      if (func.isExternal()) {
+        return;
+      }
+
+      assert(func.getBody().hasOneBlock());
+      DeviceAttr device = getCurrentScopeDevice(func);
+      assert(device);
+      Liveness liveness(func.getOperation());
+      const LivenessBlockInfo *livenessInfo =
+          liveness.getLiveness(&func.getBody().front());
+
+      // Report only the first op over capacity in every memory space.
+      //
+      llvm::SmallDenseSet<MemorySpace> reported;
+      int64_t step = 0;
+      for (Operation &op : func.getBody().front()) {
+        SmallVector<Value> buffers;
+        for (Value value : livenessInfo->currentlyLiveValues(&op)) {
+          Value buffer = getBuffer(value);
+          if (!llvm::is_contained(buffers, buffer)) {
+            buffers.push_back(buffer);
+          }
+        }
+        llvm::sort(buffers, isDefinedBefore);
+
+        for (const MemorySpaceCapacity &capacity : capacities) {
+          SmallVector<LiveBuffer> liveBuffers;
+          uint64_t highestEnd = capacity.baseAddress;
+          uint64_t unallocatedBytes = 0;
+          for (Value buffer : buffers) {
+            std::optional<LiveBuffer> liveBuffer =
+                getLiveBuffer(buffer, capacity.memorySpace, func, device);
+            if (!liveBuffer) {
+              continue;
+            }
+
+            if (liveBuffer->address) {
+              highestEnd = std::max(highestEnd, *liveBuffer->address +
+                                                    liveBuffer->sizeBytes);
+            } else {
+              unallocatedBytes += liveBuffer->sizeBytes;
+            }
+            liveBuffers.push_back(*liveBuffer);
+          }
+
+          uint64_t tensorBytes =
+              highestEnd - capacity.baseAddress + unallocatedBytes;
+          uint64_t cbBytes = capacity.memorySpace == MemorySpace::DeviceL1
+                                 ? getOpCBUsage(&op)
+                                 : 0;
+          uint64_t totalBytes = tensorBytes + cbBytes;
+          csvStream << func.getSymName() << "," << step << ","
+                    << op.getName() << ","
+                    << stringifyMemorySpace(capacity.memorySpace) << ","
+                    << tensorBytes << "," << cbBytes << "," << totalBytes
+                    << "," << capacity.size << "," << liveBuffers.size()
+                    << "\n";
+
+          if (totalBytes <= capacity.size ||
+              !reported.insert(capacity.memorySpace).second) {
+            continue;
+          }
+
+          overCapacity = true;
+          InFlightDiagnostic diag =
+              op.emitError() << stringifyMemorySpace(capacity.memorySpace)
+                             << " usage of " << totalBytes
+                             << " bytes per core exceeds capacity of "
+                             << capacity.size << " bytes";
+          for (const LiveBuffer &liveBuffer : liveBuffers) {
+            diag.attachNote(liveBuffer.value.getLoc())
+                << "live tensor " << liveBuffer.value.getType() << " of "
+                << liveBuffer.sizeBytes << " bytes";
+          }
+          if (cbBytes > 0) {
+            diag.attachNote(op.getLoc())
+                << "circular buffers and program of the op take " << cbBytes
+                << " bytes";
+          }
+        }
+        ++step;
+      }
+    });
+
+    if (!occupancyCsv.empty()) {
+      std::error_code error;
+      llvm::raw_fd_ostream os(occupancyCsv, error, llvm::sys::fs::OF_Text);
+      if (error) {
+        module->emitWarning()
+            << "Failed to write memory occupancy to " << occupancyCsv;
+      } else {
+        os << csv;
+      }
+    }
+
+    if (overCapacity) {
+      signalPassFailure();
+    }
   }
 };
 
@@ -22,6 +22,7 @@ void createTTIRToTTMetalBackendPipeline(
   pm.addPass(mlir::tt::ttir::createTTIRImplicitDevice(implicitDeviceOptions));
   pm.addPass(mlir::tt::ttir::createTTIRConstantAsFill());
   pm.addPass(mlir::tt::ttir::createTTIRGenericRegion());
+  pm.addPass(mlir::tt::ttir::createTTIRGenericFuse());
   mlir::tt::ttir::TTIRLayoutOptions layoutOptions;
   layoutOptions.initMemorySpace = mlir::tt::MemorySpace::DeviceL1;
   layoutOptions.defaultMemorySpace = mlir::tt::MemorySpace::DeviceL1;
@@ -29,6 +30,10 @@ void createTTIRToTTMetalBackendPipeline(
   pm.addPass(mlir::tt::ttir::createTTIRLayout(layoutOptions));
   pm.addPass(mlir::tt::ttir::createTTIRGenericRegionOperandsToMemref());
   pm.addPass(mlir::tt::ttir::createTTIRAllocate());
+  ttir::TTIRValidateMemoryPlanOptions validateMemoryPlanOptions;
+  validateMemoryPlanOptions.occupancyCsv = options.memoryOccupancyCsv;
+  pm.addPass(
+      mlir::tt::ttir::createTTIRValidateMemoryPlan(validateMemoryPlanOptions));
   pm.addPass(createConvertTTIRToTTMetalPass());
 }
 
@@ -200,6 +200,53 @@ static bool isValidDeviceLayout(::mlir::tt::TensorMemoryLayout layout) {
   return mlir::success();
 }
 
+::mlir::LogicalResult mlir::tt::ttnn::SliceOp::verify() {
+  ::mlir::RankedTensorType inputType = getInput().getType();
+  ::mlir::RankedTensorType outputType = getResult().getType();
+  ::mlir::ArrayAttr begins = getBegins();
+  ::mlir::ArrayAttr ends = getEnds();
+  ::mlir::ArrayAttr step = getStep();
+  int64_t rank = inputType.getRank();
+
+  if (outputType.getRank() != rank) {
+    return emitOpError("Input and output tensors must have the same rank");
+  }
+
+  if (static_cast<int64_t>(begins.size()) != rank ||
+      static_cast<int64_t>(ends.size()) != rank ||
+      static_cast<int64_t>(step.size()) != rank) {
+    return emitOpError(
+        "Begins, ends and step attributes must match input tensor rank");
+  }
+
+  for (int64_t i = 0; i < rank; i++) {
+    int64_t dimBegin = mlir::cast<IntegerAttr>(begins[i]).getInt();
+    int64_t dimEnd = mlir::cast<IntegerAttr>(ends[i]).getInt();
+    int64_t dimStep = mlir::cast<IntegerAttr>(step[i]).getInt();
+
+    if (dimStep <= 0) {
+      return emitOpError() << "Step must be positive, got " << dimStep
+                           << " for dimension " << i << ".";
+    }
+
+    if (dimBegin < 0 || dimBegin >= dimEnd ||
+        dimEnd > inputType.getDimSize(i)) {
+      return emitOpError() << "Invalid slice [" << dimBegin << ", " << dimEnd
+                           << ") for dimension " << i << " of size "
+                           << inputType.getDimSize(i) << ".";
+    }
+
+    int64_t expectedDimSize = (dimEnd - dimBegin + dimStep - 1) / dimStep;
+    if (outputType.getDimSize(i) != expectedDimSize) {
+      return emitOpError() << "Output dimension " << i << " must be "
+                           << expectedDimSize << ", got "
+                           << outputType.getDimSize(i) << ".";
+    }
+  }
+
+  return success();
+}
+
 ::mlir::LogicalResult mlir::tt::ttnn::ReshapeOp::verify() {
   ::mlir::RankedTensorType inputType = getInput().getType();
   ::mlir::RankedTensorType outputType = getResult().getType();
@@ -40,8 +40,20 @@ void createTTNNPipelineAnalysisPasses(
     ttir::TTIROptimizerOptions optimizerOptions;
     optimizerOptions.overrideOutputLayout = options.overrideOutputLayout;
     optimizerOptions.shardingPassEnabled = options.shardingPassEnabled;
+    optimizerOptions.shardingPolicy = options.shardingPolicy;
+    optimizerOptions.memoryAwareScheduling = options.memoryAwareScheduling;
+    optimizerOptions.l1SpillEnabled = options.l1SpillEnabled;
+    optimizerOptions.legalLayoutCacheFile = options.legalLayoutCacheFile;
+    optimizerOptions.tuningDatabaseImport = options.tuningDatabaseImport;
+    optimizerOptions.tuningDatabaseExport = options.tuningDatabaseExport;
+    optimizerOptions.optimizerReport = options.optimizerReport;
     pm.addPass(mlir::tt::ttir::createTTIROptimizer(optimizerOptions));
   }
+
+  ttir::TTIRValidateMemoryPlanOptions validateMemoryPlanOptions;
+  validateMemoryPlanOptions.occupancyCsv = options.memoryOccupancyCsv;
+  pm.addPass(
+      mlir::tt::ttir::createTTIRValidateMemoryPlan(validateMemoryPlanOptions));
 }
 
 void createTTNNPipelineLoweringPasses(
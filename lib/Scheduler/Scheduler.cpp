@@ -18,60 +18,120 @@ bool isTTIROp(mlir::Operation *op) {
 Scheduler::Scheduler(func::FuncOp *func) {
   for (auto &op : func->getOps()) {
     if (isTTIROp(&op)) {
+      opIndex[&op] = ops.size();
+      ops.push_back(&op);
       dependencies[&op] = {};
-      unscheduledOps.insert(&op);
+      dependents[&op] = {};
     }
   }
 
-  for (auto &op : func->getOps()) {
-    // Skip non TTIR operations
-    // Skip operations which do not implement DestinationStyleOpInterface
-    if (!isTTIROp(&op)) {
-      continue;
-    }
-
-    OpResult result = op.getResult(0);
+  for (mlir::Operation *op : ops) {
+    OpResult result = op->getResult(0);
 
     for (mlir::Operation *use : result.getUsers()) {
-      // Skip non TTIR operations
+      // Skip non TTIR operations and operations outside of the func body
       // Skip operations which set the result
-      if (isTTIROp(use) && use->getResult(0) != result) {
-        dependencies[use].push_back(&op);
+      if (opIndex.count(use) && use->getResult(0) != result) {
+        dependencies[use].push_back(op);
+        dependents[op].push_back(use);
       }
     }
   }
+
+  // Users always follow their producers in program order, so walking
+  // backwards visits users first
+  for (mlir::Operation *op : llvm::reverse(ops)) {
+    int64_t longestUserPath = 0;
+    for (mlir::Operation *use : dependents[op]) {
+      longestUserPath = std::max(longestUserPath, criticalPathLength[use]);
+    }
+    criticalPathLength[op] = longestUserPath + 1;
+  }
+
+  // Dependencies are counted per use, same as they are released in
+  // scheduleOp
+  for (mlir::Operation *op : ops) {
+    inDegree[op] = dependencies[op].size();
+    if (inDegree[op] == 0) {
+      addReadyOp(op);
+    }
+  }
 }
 
 Scheduler::Scheduler(const Scheduler &scheduler)
-    : scheduledOpsMap(scheduler.scheduledOpsMap), schedule(scheduler.schedule),
-      unscheduledOps(scheduler.unscheduledOps),
-      dependencies(scheduler.dependencies) {}
+    : ops(scheduler.ops), opIndex(scheduler.opIndex),
+      scheduledOpsMap(scheduler.scheduledOpsMap), schedule(scheduler.schedule),
+      readyOps(scheduler.readyOps),
+      readyOpsByCriticalPath(scheduler.readyOpsByCriticalPath),
+      inDegree(scheduler.inDegree),
+      dependencies(scheduler.dependencies), dependents(scheduler.dependents),
+      criticalPathLength(scheduler.criticalPathLength) {}
 
 llvm::SmallVector<mlir::Operation *> Scheduler::getScheduleableOps() {
   llvm::SmallVector<mlir::Operation *> scheduleableOps;
-  for (auto &op : unscheduledOps) {
-    if (canSchedule(op)) {
-      scheduleableOps.push_back(op);
-    }
+  scheduleableOps.reserve(readyOps.size());
+  for (unsigned index : readyOps) {
+    scheduleableOps.push_back(ops[index]);
   }
 
   return scheduleableOps;
 }
 
-bool Scheduler::canSchedule(mlir::Operation *op) {
-  for (mlir::Operation *dep : dependencies[op]) {
-    if (!scheduledOpsMap.count(dep)) {
-      return false;
+mlir::Operation *
+Scheduler::getNextScheduleableOp(const PriorityFn &priority) const {
+  mlir::Operation *bestOp = nullptr;
+  int64_t bestPriority = 0;
+  for (unsigned index : readyOps) {
+    int64_t opPriority = priority(ops[index]);
+    if (bestOp == nullptr || opPriority > bestPriority) {
+      bestOp = ops[index];
+      bestPriority = opPriority;
     }
   }
 
-  return true;
+  return bestOp;
+}
+
+mlir::Operation *Scheduler::getNextCriticalPathOp() const {
+  if (readyOpsByCriticalPath.empty()) {
+    return nullptr;
+  }
+
+  return ops[readyOpsByCriticalPath.begin()->second];
+}
+
+void Scheduler::addReadyOp(mlir::Operation *op) {
+  unsigned index = getOpIndex(op);
+  readyOps.insert(index);
+  readyOpsByCriticalPath.insert({-criticalPathLength.lookup(op), index});
+}
+
+unsigned Scheduler::getOpIndex(mlir::Operation *op) const {
+  auto index = opIndex.find(op);
+  assert(index != opIndex.end() && "Operation is not tracked by scheduler");
+  return index->second;
+}
+
+bool Scheduler::canSchedule(mlir::Operation *op) {
+  return inDegree.lookup(op) == 0;
 }
 
 void Scheduler::scheduleOp(mlir::Operation *op) {
-  scheduledOpsMap.insert(op);
-  unscheduledOps.erase(op);
+  assert(canSchedule(op) && "Scheduling op with unscheduled dependencies");
+  unsigned index = getOpIndex(op);
+  if (!scheduledOpsMap.insert(op).second) {
+    return;
+  }
+
+  readyOps.erase(index);
+  readyOpsByCriticalPath.erase({-criticalPathLength.lookup(op), index});
   schedule.push_back(op);
+
+  for (mlir::Operation *use : dependents[op]) {
+    if (--inDegree[use] == 0) {
+      addReadyOp(use);
+    }
+  }
 }
 
 std::unique_ptr<Scheduler> Scheduler::snapshot() {
@@ -82,5 +142,15 @@ llvm::SmallVector<mlir::Operation *> Scheduler::getSchedule() const {
   return schedule;
 }
 
-bool Scheduler::hasUnscheduledOps() const { return !unscheduledOps.empty(); }
+bool Scheduler::hasUnscheduledOps() const {
+  return schedule.size() < ops.size();
+}
+
+int64_t Scheduler::getCriticalPathLength(mlir::Operation *op) const {
+  return criticalPathLength.lookup(op);
+}
+
+Scheduler::PriorityFn Scheduler::criticalPathPriority() const {
+  return [this](mlir::Operation *op) { return getCriticalPathLength(op); };
+}
 } // namespace mlir::tt::scheduler
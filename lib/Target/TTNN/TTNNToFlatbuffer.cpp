@@ -367,6 +367,24 @@ createReshapeOp(FlatbufferObjectCache &cache, ReshapeOp op) {
   return ::tt::target::ttnn::CreateReshapeOp(*cache.fbb, in, out, shape);
 }
 
+template <typename SliceOp>
+::flatbuffers::Offset<::tt::target::ttnn::SliceOp>
+createSliceOp(FlatbufferObjectCache &cache, SliceOp op) {
+  auto in =
+      cache.at<::tt::target::TensorRef>(getOperandThroughDPSOps(op.getInput()));
+  auto begins =
+      arrayAttrToFlatbuffer<mlir::IntegerAttr, int>(cache, op.getBegins());
+  auto ends =
+      arrayAttrToFlatbuffer<mlir::IntegerAttr, int>(cache, op.getEnds());
+  auto step =
+      arrayAttrToFlatbuffer<mlir::IntegerAttr, int>(cache, op.getStep());
+  auto out = cache.getOrCreate(op.getResult(), tensorValueToFlatbuffer,
+                               kHostAllocatedAddress, kHostAllocatedSize);
+
+  return ::tt::target::ttnn::CreateSliceOp(*cache.fbb, in, out, begins, ends,
+                                           step);
+}
+
 template <typename MaxPool2dOp>
 ::flatbuffers::Offset<::tt::target::ttnn::MaxPool2dOp>
 createMaxPool2dOp(FlatbufferObjectCache &cache, MaxPool2dOp op) {
@@ -532,6 +550,9 @@ emitTTNNOperation(FlatbufferObjectCache &cache, Operation *op,
     return createOperation(cache, createReshapeOp(cache, reshapeOp),
                            debugString);
   }
+  if (auto sliceOp = dyn_cast<SliceOp>(op); sliceOp) {
+    return createOperation(cache, createSliceOp(cache, sliceOp), debugString);
+  }
   if (auto max_pool2dOp = dyn_cast<MaxPool2dOp>(op); max_pool2dOp) {
     return createOperation(cache, createMaxPool2dOp(cache, max_pool2dOp),
                            debugString);
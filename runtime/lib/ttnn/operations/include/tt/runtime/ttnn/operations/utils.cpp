@@ -73,9 +73,9 @@ createMemoryConfig(const ::tt::target::TensorRef *tensorRef) {
   const ::flatbuffers::Vector<int32_t> *targetShardShape =
       layout->memory_desc()->shape();
 
-  assert(targetCoreRangeSet->size() == 1 &&
-         "Currently only single core range/grid is supported");
-
+  // Core range set may be made of several rectangles, e.g. full rows of the
+  // worker grid followed by a partial one.
+  //
   assert(targetShardShape->size() == 2 &&
          "Only 2D shard shape is supported in TTNN backend");
 
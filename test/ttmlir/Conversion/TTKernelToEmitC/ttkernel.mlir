@@ -44,6 +44,11 @@ module attributes {} {
       "ttkernel.cb_pop_front"(%arg1, %c4_i32) : (!ttkernel.cb<cb_in0, 294912, memref<2x4x!tt.tile<32x32, f32>, #l1_>, 4096, 1>, i32) -> ()
       // CHECK: emitc.call_opaque "cb_push_back"[[C:.*]]
       "ttkernel.cb_push_back"(%arg2, %c4_i32) : (!ttkernel.cb<cb_out0, 327680, memref<64x128xf32, #l1_>, 4096, 1>, i32) -> ()
+      %c0_i32 = arith.constant 0 : i32
+      // CHECK: emitc.call_opaque "binary_dest_reuse_tiles_init"{{.*}}template_args = [#emitc.opaque<"EltwiseBinaryType::ELWADD">, #emitc.opaque<"EltwiseBinaryReuseDestType::DEST_TO_SRCA">]
+      "ttkernel.binary_dest_reuse_tiles_init"(%arg1) <{eltwise_type = #ttkernel.eltwise_binary_type<add>}> : (!ttkernel.cb<cb_in0, 294912, memref<2x4x!tt.tile<32x32, f32>, #l1_>, 4096, 1>) -> ()
+      // CHECK: emitc.call_opaque "binary_dest_reuse_tiles"{{.*}}template_args = [#emitc.opaque<"EltwiseBinaryType::ELWMUL">, #emitc.opaque<"EltwiseBinaryReuseDestType::DEST_TO_SRCA">]
+      "ttkernel.binary_dest_reuse_tiles"(%arg1, %c0_i32, %c0_i32) <{eltwise_type = #ttkernel.eltwise_binary_type<mul>}> : (!ttkernel.cb<cb_in0, 294912, memref<2x4x!tt.tile<32x32, f32>, #l1_>, 4096, 1>, i32, i32) -> ()
       // CHECK: return
       "ttkernel.return"() : () -> ()
   }
@@ -0,0 +1,73 @@
+// RUN: not ttmlir-opt --split-input-file %s 2>&1 | FileCheck %s
+// Negative tests for slice operation
+
+// Verify that the parsing fails if input and output ranks differ
+#any_device_tile = #tt.operand_constraint<dram|l1|tile|any_device_tile>
+module attributes {} {
+  func.func @slice_negative_1(%arg0: tensor<128x64xbf16>) -> tensor<64xbf16> {
+    // CHECK: error: 'ttir.slice' op Input and output tensors must have the same rank
+    %0 = tensor.empty() : tensor<64xbf16>
+    %1 = "ttir.slice"(%arg0, %0) <{begins = [0: i32, 0: i32], ends = [64: i32, 1: i32], step = [1: i32, 1: i32], operand_constraints = [#any_device_tile, #any_device_tile]}> : (tensor<128x64xbf16>, tensor<64xbf16>) -> tensor<64xbf16>
+    return %1 : tensor<64xbf16>
+  }
+}
+
+// -----
+// Verify that the parsing fails if attributes don't match input rank
+#any_device_tile = #tt.operand_constraint<dram|l1|tile|any_device_tile>
+module attributes {} {
+  func.func @slice_negative_2(%arg0: tensor<128x64xbf16>) -> tensor<64x64xbf16> {
+    // CHECK: error: 'ttir.slice' op Begins, ends and step attributes must match input tensor rank
+    %0 = tensor.empty() : tensor<64x64xbf16>
+    %1 = "ttir.slice"(%arg0, %0) <{begins = [0: i32], ends = [64: i32, 64: i32], step = [1: i32, 1: i32], operand_constraints = [#any_device_tile, #any_device_tile]}> : (tensor<128x64xbf16>, tensor<64x64xbf16>) -> tensor<64x64xbf16>
+    return %1 : tensor<64x64xbf16>
+  }
+}
+
+// -----
+// Verify that the parsing fails if step is not positive
+#any_device_tile = #tt.operand_constraint<dram|l1|tile|any_device_tile>
+module attributes {} {
+  func.func @slice_negative_3(%arg0: tensor<128x64xbf16>) -> tensor<64x64xbf16> {
+    // CHECK: error: 'ttir.slice' op Step must be positive, got 0 for dimension 1.
+    %0 = tensor.empty() : tensor<64x64xbf16>
+    %1 = "ttir.slice"(%arg0, %0) <{begins = [0: i32, 0: i32], ends = [64: i32, 64: i32], step = [1: i32, 0: i32], operand_constraints = [#any_device_tile, #any_device_tile]}> : (tensor<128x64xbf16>, tensor<64x64xbf16>) -> tensor<64x64xbf16>
+    return %1 : tensor<64x64xbf16>
+  }
+}
+
+// -----
+// Verify that the parsing fails if slice is empty
+#any_device_tile = #tt.operand_constraint<dram|l1|tile|any_device_tile>
+module attributes {} {
+  func.func @slice_negative_4(%arg0: tensor<128x64xbf16>) -> tensor<64x64xbf16> {
+    // CHECK: error: 'ttir.slice' op Invalid slice [64, 64) for dimension 0 of size 128.
+    %0 = tensor.empty() : tensor<64x64xbf16>
+    %1 = "ttir.slice"(%arg0, %0) <{begins = [64: i32, 0: i32], ends = [64: i32, 64: i32], step = [1: i32, 1: i32], operand_constraints = [#any_device_tile, #any_device_tile]}> : (tensor<128x64xbf16>, tensor<64x64xbf16>) -> tensor<64x64xbf16>
+    return %1 : tensor<64x64xbf16>
+  }
+}
+
+// -----
+// Verify that the parsing fails if slice is out of bounds
+#any_device_tile = #tt.operand_constraint<dram|l1|tile|any_device_tile>
+module attributes {} {
+  func.func @slice_negative_5(%arg0: tensor<128x64xbf16>) -> tensor<96x64xbf16> {
+    // CHECK: error: 'ttir.slice' op Invalid slice [64, 160) for dimension 0 of size 128.
+    %0 = tensor.empty() : tensor<96x64xbf16>
+    %1 = "ttir.slice"(%arg0, %0) <{begins = [64: i32, 0: i32], ends = [160: i32, 64: i32], step = [1: i32, 1: i32], operand_constraints = [#any_device_tile, #any_device_tile]}> : (tensor<128x64xbf16>, tensor<96x64xbf16>) -> tensor<96x64xbf16>
+    return %1 : tensor<96x64xbf16>
+  }
+}
+
+// -----
+// Verify that the parsing fails if output shape doesn't match the slice
+#any_device_tile = #tt.operand_constraint<dram|l1|tile|any_device_tile>
+module attributes {} {
+  func.func @slice_negative_6(%arg0: tensor<128x64xbf16>) -> tensor<64x64xbf16> {
+    // CHECK: error: 'ttir.slice' op Output dimension 0 must be 32, got 64.
+    %0 = tensor.empty() : tensor<64x64xbf16>
+    %1 = "ttir.slice"(%arg0, %0) <{begins = [0: i32, 0: i32], ends = [64: i32, 64: i32], step = [2: i32, 1: i32], operand_constraints = [#any_device_tile, #any_device_tile]}> : (tensor<128x64xbf16>, tensor<64x64xbf16>) -> tensor<64x64xbf16>
+    return %1 : tensor<64x64xbf16>
+  }
+}
@@ -0,0 +1,17 @@
+// RUN: ttmlir-opt %s | FileCheck %s
+#any_device_tile = #tt.operand_constraint<dram|l1|tile|any_device_tile>
+module attributes {} {
+  func.func @slice_outer_dim(%arg0: tensor<128x64xbf16>) -> tensor<64x64xbf16> {
+    %0 = tensor.empty() : tensor<64x64xbf16>
+    // CHECK: %[[C:.*]] = "ttir.slice"[[C:.*]]
+    %1 = "ttir.slice"(%arg0, %0) <{begins = [64: i32, 0: i32], ends = [128: i32, 64: i32], step = [1: i32, 1: i32], operand_constraints = [#any_device_tile, #any_device_tile]}> : (tensor<128x64xbf16>, tensor<64x64xbf16>) -> tensor<64x64xbf16>
+    return %1 : tensor<64x64xbf16>
+  }
+
+  func.func @slice_with_step(%arg0: tensor<4x128x64xbf16>) -> tensor<2x43x64xbf16> {
+    %0 = tensor.empty() : tensor<2x43x64xbf16>
+    // CHECK: %[[C:.*]] = "ttir.slice"[[C:.*]]
+    %1 = "ttir.slice"(%arg0, %0) <{begins = [1: i32, 0: i32, 0: i32], ends = [4: i32, 128: i32, 64: i32], step = [2: i32, 3: i32, 1: i32], operand_constraints = [#any_device_tile, #any_device_tile]}> : (tensor<4x128x64xbf16>, tensor<2x43x64xbf16>) -> tensor<2x43x64xbf16>
+    return %1 : tensor<2x43x64xbf16>
+  }
+}
@@ -10,4 +10,21 @@ module attributes {} {
     %1 = "ttir.multiply"(%arg0, %arg1, %0) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32, #layout>, tensor<64x128xf32, #layout>, tensor<64x128xf32, #layout>) -> tensor<64x128xf32, #layout>
     return %1 : tensor<64x128xf32, #layout>
   }
+
+  // Output of the first multiply is dead once the second one ran, the third
+  // one reuses its memory.
+  func.func @reuse(%arg0: tensor<64x128xf32, #layout>, %arg1: tensor<64x128xf32, #layout>) -> tensor<64x128xf32, #layout> {
+    // CHECK-LABEL: func.func @reuse
+    // CHECK: "ttir.alloc"() <{address = [[FIRST:[0-9]+]] : i64
+    // CHECK: "ttir.alloc"() <{address = [[SECOND:[0-9]+]] : i64
+    // CHECK: "ttir.dealloc"
+    // CHECK: "ttir.alloc"() <{address = [[FIRST]] : i64
+    %0 = tensor.empty() : tensor<64x128xf32, #layout>
+    %1 = "ttir.multiply"(%arg0, %arg1, %0) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32, #layout>, tensor<64x128xf32, #layout>, tensor<64x128xf32, #layout>) -> tensor<64x128xf32, #layout>
+    %2 = tensor.empty() : tensor<64x128xf32, #layout>
+    %3 = "ttir.multiply"(%1, %arg1, %2) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32, #layout>, tensor<64x128xf32, #layout>, tensor<64x128xf32, #layout>) -> tensor<64x128xf32, #layout>
+    %4 = tensor.empty() : tensor<64x128xf32, #layout>
+    %5 = "ttir.multiply"(%3, %arg1, %4) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32, #layout>, tensor<64x128xf32, #layout>, tensor<64x128xf32, #layout>) -> tensor<64x128xf32, #layout>
+    return %5 : tensor<64x128xf32, #layout>
+  }
 }
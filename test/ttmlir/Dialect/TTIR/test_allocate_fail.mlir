@@ -0,0 +1,18 @@
+// RUN: not ttmlir-opt --ttir-load-system-desc --ttir-implicit-device --ttir-allocate %s 2>&1 | FileCheck %s
+#any_device = #tt.operand_constraint<dram|l1|scalar|tile|any_device|any_device_tile>
+#dram = #tt.memory_space<dram>
+#l1_ = #tt.memory_space<l1>
+#dram_layout = #tt.layout<(d0, d1) -> (d0, d1), undef, <1x1>, memref<512x512xf32, #dram>, interleaved>
+#l1_layout = #tt.layout<(d0, d1) -> (d0, d1), undef, <1x1>, memref<512x512xf32, #l1_>, interleaved>
+module attributes {} {
+  // Output of the first multiply is still live when the second one needs
+  // another 1MB of L1 on the single core.
+  func.func @forward(%arg0: tensor<512x512xf32, #dram_layout>, %arg1: tensor<512x512xf32, #dram_layout>) -> tensor<512x512xf32, #l1_layout> {
+    %0 = tensor.empty() : tensor<512x512xf32, #l1_layout>
+    %1 = "ttir.multiply"(%arg0, %arg1, %0) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<512x512xf32, #dram_layout>, tensor<512x512xf32, #dram_layout>, tensor<512x512xf32, #l1_layout>) -> tensor<512x512xf32, #l1_layout>
+    // CHECK: error: 'tensor.empty' op failed to allocate 1048576 bytes in l1 memory
+    %2 = tensor.empty() : tensor<512x512xf32, #l1_layout>
+    %3 = "ttir.multiply"(%1, %1, %2) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<512x512xf32, #l1_layout>, tensor<512x512xf32, #l1_layout>, tensor<512x512xf32, #l1_layout>) -> tensor<512x512xf32, #l1_layout>
+    return %3 : tensor<512x512xf32, #l1_layout>
+  }
+}
@@ -0,0 +1,24 @@
+// RUN: ttmlir-opt --ttir-load-system-desc --ttir-implicit-device --ttir-layout --ttir-optimizer="sharding-pass-enabled=true sharding-policy=dag" %s | FileCheck %s --check-prefixes=CHECK,DAGSHARD
+// RUN: ttmlir-opt --ttir-load-system-desc --ttir-implicit-device --ttir-layout --ttir-optimizer="sharding-pass-enabled=true sharding-policy=df" %s | FileCheck %s --check-prefixes=CHECK,DFSHARD
+#any_device = #tt.operand_constraint<dram|l1|scalar|tile|any_device|any_device_tile>
+module attributes {} {
+  // Residual block, %1 forks into %3 and the add joining both branches. DF
+  // sharding ends a chain at every fork, so %1 and the add stay in DRAM. DAG
+  // sharding keeps the whole block sharded in L1.
+  func.func @forward(%arg0: tensor<64x128xf32>) -> tensor<64x128xf32> {
+    // CHECK-DAG: #[[SHARDED:layout[0-9]*]] = #tt.layout<{{.*}}#l1_>, {{.*}}_sharded>
+    // DFSHARD-DAG: #[[DRAM:layout[0-9]*]] = #tt.layout<{{.*}}#dram>, interleaved>
+    %0 = tensor.empty() : tensor<64x128xf32>
+    // DAGSHARD: %[[A:.*]] = "ttir.relu"{{.*}} -> tensor<64x128xf32, #[[SHARDED]]>
+    // DFSHARD: %[[A:.*]] = "ttir.relu"{{.*}} -> tensor<64x128xf32, #[[DRAM]]>
+    %1 = "ttir.relu"(%arg0, %0) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %2 = tensor.empty() : tensor<64x128xf32>
+    // CHECK: %[[B:.*]] = "ttir.relu"({{.*}} -> tensor<64x128xf32, #[[SHARDED]]>
+    %3 = "ttir.relu"(%1, %2) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %4 = tensor.empty() : tensor<64x128xf32>
+    // DAGSHARD: "ttir.add"(%[[B]], %[[A]], {{.*}} -> tensor<64x128xf32, #[[SHARDED]]>
+    // DFSHARD: "ttir.add"(%[[B]], {{.*}} -> tensor<64x128xf32, #[[DRAM]]>
+    %5 = "ttir.add"(%3, %1, %4) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    return %5 : tensor<64x128xf32>
+  }
+}
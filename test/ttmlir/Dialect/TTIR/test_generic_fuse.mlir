@@ -0,0 +1,40 @@
+// RUN: ttmlir-opt --ttir-generic --ttir-generic-fuse %s | FileCheck %s
+#any_device = #tt.operand_constraint<dram|l1|scalar|tile|any_device|any_device_tile>
+module attributes {} {
+  // CHECK-LABEL: func.func @chain
+  func.func @chain(%arg0: tensor<64x128xf32>, %arg1: tensor<64x128xf32>, %arg2: tensor<64x128xf32>) -> tensor<64x128xf32> {
+    // CHECK: "ttir.generic"(%arg0, %arg1, %arg2, %{{.*}})
+    // CHECK: %[[MUL:.*]] = arith.mulf
+    // CHECK-NEXT: arith.addf %{{.*}}, %[[MUL]]
+    // CHECK-NEXT: math.exp
+    // CHECK-NEXT: math.exp
+    // CHECK-NEXT: ttir.yield
+    // CHECK-NOT: "ttir.generic"
+    %0 = tensor.empty() : tensor<64x128xf32>
+    %1 = "ttir.multiply"(%arg0, %arg1, %0) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %2 = tensor.empty() : tensor<64x128xf32>
+    %3 = "ttir.add"(%arg2, %1, %2) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %4 = tensor.empty() : tensor<64x128xf32>
+    %5 = "ttir.exp"(%3, %4) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %6 = tensor.empty() : tensor<64x128xf32>
+    %7 = "ttir.exp"(%5, %6) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    return %7 : tensor<64x128xf32>
+  }
+
+  // Div is not commutative, so it can't take the tile in dst register as its
+  // first operand, and producers with other users must write their result.
+  // Neither is fused.
+  // CHECK-LABEL: func.func @not_fused
+  func.func @not_fused(%arg0: tensor<64x128xf32>, %arg1: tensor<64x128xf32>) -> (tensor<64x128xf32>, tensor<64x128xf32>) {
+    // CHECK: "ttir.generic"
+    // CHECK: "ttir.generic"
+    // CHECK: "ttir.generic"
+    %0 = tensor.empty() : tensor<64x128xf32>
+    %1 = "ttir.exp"(%arg0, %0) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %2 = tensor.empty() : tensor<64x128xf32>
+    %3 = "ttir.div"(%1, %arg1, %2) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %4 = tensor.empty() : tensor<64x128xf32>
+    %5 = "ttir.exp"(%3, %4) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    return %3, %5 : tensor<64x128xf32>, tensor<64x128xf32>
+  }
+}
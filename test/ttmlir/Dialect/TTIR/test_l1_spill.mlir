@@ -0,0 +1,27 @@
+// RUN: ttmlir-opt --ttir-load-system-desc --ttir-implicit-device --ttir-layout --ttir-optimizer="sharding-pass-enabled=true sharding-policy=dag l1-spill-enabled=true" %s | FileCheck %s
+#any_device = #tt.operand_constraint<dram|l1|scalar|tile|any_device|any_device_tile>
+module attributes {} {
+  // Every tensor takes a bit over a quarter of L1 per core on the 8x8 grid.
+  // %1, %3, %5 and %7 would all be in L1 at %7, so %1 is spilled after its
+  // last user before it, %3, and refilled before %9.
+  func.func @forward(%arg0: tensor<4096x1536xf32>) -> tensor<4096x1536xf32> {
+    %0 = tensor.empty() : tensor<4096x1536xf32>
+    // CHECK: %[[A:.*]] = "ttir.relu"{{.*}} -> tensor<4096x1536xf32, #[[SHARDED:layout[0-9]*]]>
+    %1 = "ttir.relu"(%arg0, %0) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<4096x1536xf32>, tensor<4096x1536xf32>) -> tensor<4096x1536xf32>
+    %2 = tensor.empty() : tensor<4096x1536xf32>
+    // CHECK: %[[B:.*]] = "ttir.relu"(%[[A]], {{.*}} -> tensor<4096x1536xf32, #[[SHARDED]]>
+    %3 = "ttir.relu"(%1, %2) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<4096x1536xf32>, tensor<4096x1536xf32>) -> tensor<4096x1536xf32>
+    // CHECK: %[[SPILL:.*]] = "ttir.to_layout"(%[[A]],
+    %4 = tensor.empty() : tensor<4096x1536xf32>
+    // CHECK: %[[C:.*]] = "ttir.relu"(%[[B]], {{.*}} -> tensor<4096x1536xf32, #[[SHARDED]]>
+    %5 = "ttir.relu"(%3, %4) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<4096x1536xf32>, tensor<4096x1536xf32>) -> tensor<4096x1536xf32>
+    %6 = tensor.empty() : tensor<4096x1536xf32>
+    // CHECK: %[[D:.*]] = "ttir.add"(%[[C]], %[[B]],
+    %7 = "ttir.add"(%5, %3, %6) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<4096x1536xf32>, tensor<4096x1536xf32>, tensor<4096x1536xf32>) -> tensor<4096x1536xf32>
+    %8 = tensor.empty() : tensor<4096x1536xf32>
+    // CHECK: %[[REFILL:.*]] = "ttir.to_layout"(%[[SPILL]], {{.*}} -> tensor<4096x1536xf32, #[[SHARDED]]>
+    // CHECK: "ttir.add"(%[[D]], %[[REFILL]],
+    %9 = "ttir.add"(%7, %1, %8) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<4096x1536xf32>, tensor<4096x1536xf32>, tensor<4096x1536xf32>) -> tensor<4096x1536xf32>
+    return %9 : tensor<4096x1536xf32>
+  }
+}
@@ -0,0 +1,39 @@
+// RUN: ttmlir-opt --ttir-load-system-desc --ttir-implicit-device --ttir-layout %s | FileCheck %s
+// RUN: ttmlir-opt --ttir-load-system-desc --ttir-implicit-device --ttir-layout --mlir-pass-statistics %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=STATS
+// Second reads of %arg0 and %arg1 in @forward and of %arg0 in @dps_output.
+// STATS: 3 deduplicated-to-layouts
+#any_device = #tt.operand_constraint<dram|l1|scalar|tile|any_device|any_device_tile>
+module attributes {} {
+  // Both arguments are read by two ops, each is moved to device once.
+  // CHECK-LABEL: func.func @forward
+  func.func @forward(%arg0: tensor<64x128xf32>, %arg1: tensor<64x128xf32>) -> tensor<64x128xf32> {
+    // CHECK: %[[A:.*]] = "ttir.to_layout"(%arg0,
+    // CHECK: %[[B:.*]] = "ttir.to_layout"(%arg1,
+    // CHECK: "ttir.multiply"(%[[A]], %[[B]],
+    // CHECK-NOT: "ttir.to_layout"(%arg
+    // CHECK: "ttir.add"(%[[A]], %[[B]],
+    %0 = tensor.empty() : tensor<64x128xf32>
+    %1 = "ttir.multiply"(%arg0, %arg1, %0) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %2 = tensor.empty() : tensor<64x128xf32>
+    %3 = "ttir.add"(%arg0, %arg1, %2) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %4 = tensor.empty() : tensor<64x128xf32>
+    %5 = "ttir.add"(%1, %3, %4) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    return %5 : tensor<64x128xf32>
+  }
+
+  // %arg1 is written to as output of the multiply, its conversions are kept.
+  // %arg0 is only read, both ops share its conversion.
+  // CHECK-LABEL: func.func @dps_output
+  func.func @dps_output(%arg0: tensor<64x128xf32>, %arg1: tensor<64x128xf32>) -> tensor<64x128xf32> {
+    // CHECK: %[[A:.*]] = "ttir.to_layout"(%arg0,
+    // CHECK: "ttir.to_layout"(%arg1,
+    // CHECK: "ttir.add"(%[[A]],
+    // CHECK-NOT: "ttir.to_layout"(%arg0,
+    // CHECK: "ttir.to_layout"(%arg1,
+    // CHECK: "ttir.multiply"(%[[A]],
+    %0 = tensor.empty() : tensor<64x128xf32>
+    %1 = "ttir.add"(%arg0, %arg1, %0) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %2 = "ttir.multiply"(%arg0, %1, %arg1) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    return %2 : tensor<64x128xf32>
+  }
+}
@@ -0,0 +1,29 @@
+// RUN: ttmlir-opt --ttir-load-system-desc --ttir-implicit-device --ttir-layout --ttir-optimizer="sharding-pass-enabled=true resharding-enabled=true" %s | FileCheck %s
+#any_device = #tt.operand_constraint<dram|l1|scalar|tile|any_device|any_device_tile>
+module attributes {} {
+  // %1 forks, so it is left out of shard chains. Both of its users start a
+  // chain with the same sharded layout and need %1 resharded to it, a single
+  // reshard is shared by both.
+  func.func @forward(%arg0: tensor<64x128xf32>) -> tensor<64x128xf32> {
+    // CHECK: %[[P:.*]] = "ttir.relu"
+    // CHECK: %[[R:.*]] = "ttir.to_layout"(%[[P]],
+    // CHECK-NOT: "ttir.to_layout"(%[[P]],
+    // CHECK: "ttir.relu"(%[[R]],
+    // CHECK-NOT: "ttir.to_layout"(%[[P]],
+    // CHECK: "ttir.relu"(%[[R]],
+    // CHECK-NOT: "ttir.to_layout"(%[[P]],
+    %0 = tensor.empty() : tensor<64x128xf32>
+    %1 = "ttir.relu"(%arg0, %0) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %2 = tensor.empty() : tensor<64x128xf32>
+    %3 = "ttir.relu"(%1, %2) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %4 = tensor.empty() : tensor<64x128xf32>
+    %5 = "ttir.relu"(%3, %4) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %6 = tensor.empty() : tensor<64x128xf32>
+    %7 = "ttir.relu"(%1, %6) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %8 = tensor.empty() : tensor<64x128xf32>
+    %9 = "ttir.relu"(%7, %8) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %10 = tensor.empty() : tensor<64x128xf32>
+    %11 = "ttir.add"(%5, %9, %10) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    return %11 : tensor<64x128xf32>
+  }
+}
@@ -0,0 +1,50 @@
+// RUN: ttmlir-opt --ttir-load-system-desc --ttir-implicit-device --ttir-layout --ttir-optimizer="sharding-pass-enabled=true resharding-enabled=true" %s | FileCheck %s
+#any_device = #tt.operand_constraint<dram|l1|scalar|tile|any_device|any_device_tile>
+module attributes {} {
+  // Every tensor takes a bit over half of L1 per core on the 8x8 grid, so
+  // two of them don't fit together and the %1 -> %3 chain is streamed in two
+  // slices. Chain input stays in DRAM and every slice of it is resharded to
+  // L1, chain ops run once per slice and output slices are concatenated.
+  // CHECK-LABEL: func.func @forward
+  func.func @forward(%arg0: tensor<8192x1536xf32>) -> tensor<8192x1536xf32> {
+    // CHECK: %[[IN:.*]] = "ttir.to_layout"(%arg0, {{.*}} -> tensor<8192x1536xf32,
+    // CHECK: %[[S0:.*]] = "ttir.slice"(%[[IN]], {{.*}}begins = [0 : i32, 0 : i32], ends = [4096 : i32, 1536 : i32]{{.*}} -> tensor<4096x1536xf32,
+    // CHECK: %[[R0:.*]] = "ttir.to_layout"(%[[S0]], {{.*}} -> tensor<4096x1536xf32,
+    // CHECK: %[[A0:.*]] = "ttir.relu"(%[[R0]], {{.*}} -> tensor<4096x1536xf32, #[[SHARDED:layout[0-9]*]]>
+    // CHECK: %[[B0:.*]] = "ttir.relu"(%[[A0]], {{.*}} -> tensor<4096x1536xf32, #[[SHARDED]]>
+    // CHECK: %[[S1:.*]] = "ttir.slice"(%[[IN]], {{.*}}begins = [4096 : i32, 0 : i32], ends = [8192 : i32, 1536 : i32]{{.*}} -> tensor<4096x1536xf32,
+    // CHECK: %[[R1:.*]] = "ttir.to_layout"(%[[S1]], {{.*}} -> tensor<4096x1536xf32,
+    // CHECK: %[[A1:.*]] = "ttir.relu"(%[[R1]], {{.*}} -> tensor<4096x1536xf32, #[[SHARDED]]>
+    // CHECK: %[[B1:.*]] = "ttir.relu"(%[[A1]], {{.*}} -> tensor<4096x1536xf32, #[[SHARDED]]>
+    // CHECK: %[[CAT:.*]] = "ttir.concat"(%[[B0]], %[[B1]], {{.*}} -> tensor<8192x1536xf32,
+    // CHECK: "ttir.relu"(%[[CAT]],
+    // CHECK-NOT: "ttir.slice"
+    %0 = tensor.empty() : tensor<8192x1536xf32>
+    %1 = "ttir.relu"(%arg0, %0) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<8192x1536xf32>, tensor<8192x1536xf32>) -> tensor<8192x1536xf32>
+    %2 = tensor.empty() : tensor<8192x1536xf32>
+    %3 = "ttir.relu"(%1, %2) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<8192x1536xf32>, tensor<8192x1536xf32>) -> tensor<8192x1536xf32>
+    %4 = tensor.empty() : tensor<8192x1536xf32>
+    %5 = "ttir.relu"(%3, %4) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<8192x1536xf32>, tensor<8192x1536xf32>) -> tensor<8192x1536xf32>
+    return %5 : tensor<8192x1536xf32>
+  }
+
+  // Softmax along the outer dim can't be split. It fits L1 together with the
+  // matmul and starts the chain with split factor 1, but the matmul -> relu
+  // pair only fits in slices. Splitting would slice the softmax as well, so
+  // the chain ends at the matmul instead and nothing is sliced.
+  // CHECK-LABEL: func.func @non_splittable_head
+  func.func @non_splittable_head(%arg0: tensor<8192x256xf32>, %arg1: tensor<256x1536xf32>) -> tensor<8192x1536xf32> {
+    // CHECK-NOT: "ttir.slice"
+    // CHECK: "ttir.softmax"({{.*}} -> tensor<8192x256xf32,
+    // CHECK-NOT: "ttir.slice"
+    // CHECK: "ttir.matmul"({{.*}} -> tensor<8192x1536xf32,
+    // CHECK-NOT: "ttir.slice"
+    %0 = tensor.empty() : tensor<8192x256xf32>
+    %1 = "ttir.softmax"(%arg0, %0) <{dimension = 0 : si32, operand_constraints = [#any_device, #any_device]}> : (tensor<8192x256xf32>, tensor<8192x256xf32>) -> tensor<8192x256xf32>
+    %2 = tensor.empty() : tensor<8192x1536xf32>
+    %3 = "ttir.matmul"(%1, %arg1, %2) <{operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<8192x256xf32>, tensor<256x1536xf32>, tensor<8192x1536xf32>) -> tensor<8192x1536xf32>
+    %4 = tensor.empty() : tensor<8192x1536xf32>
+    %5 = "ttir.relu"(%3, %4) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<8192x1536xf32>, tensor<8192x1536xf32>) -> tensor<8192x1536xf32>
+    return %5 : tensor<8192x1536xf32>
+  }
+}
@@ -0,0 +1,17 @@
+// RUN: ttmlir-opt --ttir-load-system-desc --ttir-implicit-device --ttir-allocate --ttir-validate-memory-plan="occupancy-csv=%t.csv" %s | FileCheck %s
+// RUN: FileCheck %s --check-prefix=CSV --input-file=%t.csv
+#any_device = #tt.operand_constraint<dram|l1|scalar|tile|any_device|any_device_tile>
+#l1_ = #tt.memory_space<l1>
+#layout = #tt.layout<(d0, d1) -> (d0, d1), undef, <1x1>, memref<64x128xf32, #l1_>, interleaved>
+module attributes {} {
+  // CHECK: func.func @forward
+  func.func @forward(%arg0: tensor<64x128xf32, #layout>, %arg1: tensor<64x128xf32, #layout>) -> tensor<64x128xf32, #layout> {
+    %0 = tensor.empty() : tensor<64x128xf32, #layout>
+    %1 = "ttir.multiply"(%arg0, %arg1, %0) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32, #layout>, tensor<64x128xf32, #layout>, tensor<64x128xf32, #layout>) -> tensor<64x128xf32, #layout>
+    return %1 : tensor<64x128xf32, #layout>
+  }
+}
+// CSV: func,step,op,memory_space,tensor_bytes,cb_bytes,total_bytes,capacity_bytes,live_tensors
+// CSV: forward,0,ttir.alloc,l1,
+// CSV: forward,1,ttir.multiply,l1,{{[0-9]+}},{{[0-9]+}},{{[0-9]+}},{{[0-9]+}},3
+// CSV: forward,1,ttir.multiply,dram,0,0,0,
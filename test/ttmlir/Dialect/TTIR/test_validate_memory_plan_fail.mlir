@@ -0,0 +1,16 @@
+// RUN: not ttmlir-opt --ttir-load-system-desc --ttir-implicit-device --ttir-validate-memory-plan %s 2>&1 | FileCheck %s
+#any_device = #tt.operand_constraint<dram|l1|scalar|tile|any_device|any_device_tile>
+#l1_ = #tt.memory_space<l1>
+#layout = #tt.layout<(d0, d1) -> (d0, d1), undef, <1x1>, memref<512x512xf32, #l1_>, interleaved>
+module attributes {} {
+  // Every tensor takes 1MB of L1 of the single core it is on.
+  func.func @forward(%arg0: tensor<512x512xf32, #layout>, %arg1: tensor<512x512xf32, #layout>) -> tensor<512x512xf32, #layout> {
+    %0 = tensor.empty() : tensor<512x512xf32, #layout>
+    // CHECK: error: l1 usage of {{[0-9]+}} bytes per core exceeds capacity of {{[0-9]+}} bytes
+    // CHECK: note: live tensor tensor<512x512xf32, {{.*}}> of 1048576 bytes
+    // CHECK: note: live tensor tensor<512x512xf32, {{.*}}> of 1048576 bytes
+    // CHECK: note: live tensor tensor<512x512xf32, {{.*}}> of 1048576 bytes
+    %1 = "ttir.multiply"(%arg0, %arg1, %0) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<512x512xf32, #layout>, tensor<512x512xf32, #layout>, tensor<512x512xf32, #layout>) -> tensor<512x512xf32, #layout>
+    return %1 : tensor<512x512xf32, #layout>
+  }
+}
@@ -0,0 +1,22 @@
+// RUN: ttmlir-opt --ttir-to-ttnn-backend-pipeline="enable-optimizer=true sharding-pass-enabled=true optimizer-report=%t.json" %s
+// RUN: FileCheck %s --input-file=%t.json
+#any_device = #tt.operand_constraint<dram|l1|scalar|tile|any_device|any_device_tile>
+module attributes {} {
+  func.func @forward(%arg0: tensor<64x128xf32>, %arg1: tensor<64x128xf32>) -> tensor<64x128xf32> {
+    // CHECK: "format_version": 1
+    // CHECK: "l1_timeline": [
+    // CHECK: "name": "forward"
+    // CHECK: "ops": [
+    // CHECK: "op": "ttir.add"
+    // CHECK: "step": 0
+    // CHECK: "op": "ttir.relu"
+    // CHECK: "step": 1
+    // CHECK: "reshards": [
+    // CHECK: "shard_chains": [
+    %0 = tensor.empty() : tensor<64x128xf32>
+    %1 = "ttir.add"(%arg0, %arg1, %0) <{operandSegmentSizes = array<i32: 2, 1>, operand_constraints = [#any_device, #any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    %2 = tensor.empty() : tensor<64x128xf32>
+    %3 = "ttir.relu"(%1, %2) <{operandSegmentSizes = array<i32: 1, 1>, operand_constraints = [#any_device, #any_device]}> : (tensor<64x128xf32>, tensor<64x128xf32>) -> tensor<64x128xf32>
+    return %3 : tensor<64x128xf32>
+  }
+}
@@ -0,0 +1,10 @@
+// RUN: not ttmlir-opt --ttir-to-ttnn-backend-pipeline %s 2>&1 | FileCheck %s
+// CHECK: error: 'ttir.slice' op Invalid slice [64, 160) for dimension 0 of size 128.
+#any_device_tile = #tt.operand_constraint<dram|l1|tile|any_device_tile>
+module attributes {} {
+  func.func @forward(%arg0: tensor<128x64xbf16>) -> tensor<96x64xbf16> {
+    %0 = tensor.empty() : tensor<96x64xbf16>
+    %1 = "ttir.slice"(%arg0, %0) <{begins = [64: i32, 0: i32], ends = [160: i32, 64: i32], step = [1: i32, 1: i32], operand_constraints = [#any_device_tile, #any_device_tile]}> : (tensor<128x64xbf16>, tensor<96x64xbf16>) -> tensor<96x64xbf16>
+    return %1 : tensor<96x64xbf16>
+  }
+}
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TTMLIR_TEST_UNITTESTS_OPTIMIZER_OPTIMIZERTESTBASE_H
+#define TTMLIR_TEST_UNITTESTS_OPTIMIZER_OPTIMIZERTESTBASE_H
+
+#include <gtest/gtest.h>
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/MLIRContext.h"
+
+#include "ttmlir/Dialect/TT/IR/TT.h"
+#include "ttmlir/Dialect/TT/IR/TTOpsTypes.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutSizeCache.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LegalGridAnalysis.h"
+#include "ttmlir/Dialect/TTIR/Analysis/LegalLayoutCache.h"
+#include "ttmlir/Dialect/TTIR/Analysis/OpCostModel.h"
+#include "ttmlir/Dialect/TTIR/IR/TTIR.h"
+#include "ttmlir/Dialect/TTIR/IR/TTIROps.h"
+
+namespace mlir::tt::ttir {
+
+// Module on the default system desc and device, with helpers building small
+// TTIR graphs and running the optimizer analyses on them.
+//
+class OptimizerTestBase : public ::testing::Test {
+public:
+  mlir::MLIRContext context;
+  mlir::OwningOpRef<mlir::ModuleOp> module;
+  mlir::OpBuilder builder = mlir::OpBuilder(&context);
+  mlir::func::FuncOp func;
+  SystemDescAttr systemDesc;
+  DeviceAttr device;
+  LayoutSizeCache layoutSizeCache;
+  mlir::Attribute anyDevice;
+
+  void SetUp() override {
+    context.loadDialect<TTDialect>();
+    context.loadDialect<TTIRDialect>();
+    context.loadDialect<mlir::tensor::TensorDialect>();
+    module = mlir::ModuleOp::create(builder.getUnknownLoc());
+
+    // Analyses look up the device in the op's scope.
+    systemDesc = SystemDescAttr::getDefault(&context);
+    device = DeviceAttr::get(&context, systemDesc);
+    (*module)->setAttr(SystemDescAttr::name, systemDesc);
+    (*module)->setAttr(DeviceAttr::name, device);
+    anyDevice = builder.getAttr<OperandConstraintAttr>(
+        OperandConstraint::AnyDevice);
+    builder.setInsertionPointToStart(&module->getBodyRegion().front());
+  }
+
+  // DRAM tensor of dimX x dimY f32 elements.
+  //
+  mlir::RankedTensorType getTensorType(int64_t dimX, int64_t dimY) {
+    mlir::RankedTensorType tensorType =
+        mlir::RankedTensorType::get({dimX, dimY}, builder.getF32Type());
+    LayoutAttr layout = LayoutAttr::get(&context, tensorType,
+                                        MemorySpace::DeviceDRAM,
+                                        GridAttr::get(&context, 2));
+    return mlir::RankedTensorType::get(tensorType.getShape(),
+                                       tensorType.getElementType(), layout);
+  }
+
+  // Block sharded L1 layout of tensorType on a gridR x gridC grid.
+  //
+  LayoutAttr getShardedLayout(mlir::RankedTensorType tensorType,
+                              int64_t gridR, int64_t gridC) {
+    return mlir::cast<LayoutAttr>(tensorType.getEncoding())
+        .withMemorySpace(&context, MemorySpace::DeviceL1)
+        .withMemoryLayout(&context, TensorMemoryLayout::BlockSharded)
+        .withGrid(&context, tensorType,
+                  GridAttr::get(&context, {gridR, gridC}));
+  }
+
+  mlir::Value createEmptyTensor(mlir::RankedTensorType tensorType) {
+    return builder.create<mlir::tensor::EmptyOp>(
+        builder.getUnknownLoc(), tensorType.getShape(),
+        tensorType.getElementType(), tensorType.getEncoding());
+  }
+
+  // Appends a func taking and returning a tensor of tensorType to the module
+  // and moves the insertion point into its body.
+  //
+  mlir::func::FuncOp createFunc(mlir::RankedTensorType tensorType) {
+    builder.setInsertionPointToEnd(&module->getBodyRegion().front());
+    auto funcType = builder.getType<mlir::FunctionType>(
+        mlir::TypeRange(tensorType), mlir::TypeRange(tensorType));
+    func = builder.create<mlir::func::FuncOp>(builder.getUnknownLoc(), "test",
+                                              funcType);
+    builder.setInsertionPointToStart(func.addEntryBlock());
+    return func;
+  }
+
+  mlir::Operation *createRelu(mlir::Value input) {
+    return builder.create<ReluOp>(
+        builder.getUnknownLoc(), input,
+        createEmptyTensor(mlir::cast<mlir::RankedTensorType>(input.getType())),
+        builder.getArrayAttr({anyDevice, anyDevice}));
+  }
+
+  mlir::Operation *createAdd(mlir::Value lhs, mlir::Value rhs) {
+    return builder.create<AddOp>(
+        builder.getUnknownLoc(), lhs, rhs,
+        createEmptyTensor(mlir::cast<mlir::RankedTensorType>(lhs.getType())),
+        builder.getArrayAttr({anyDevice, anyDevice, anyDevice}));
+  }
+
+  void createReturn(mlir::Operation *op) {
+    builder.create<mlir::func::ReturnOp>(builder.getUnknownLoc(),
+                                         op->getResult(0));
+  }
+
+  // Creates a func with a single relu op on dimX x dimY tensor.
+  //
+  mlir::Operation *createRelu(int64_t dimX, int64_t dimY) {
+    createFunc(getTensorType(dimX, dimY));
+    mlir::Operation *relu = createRelu(func.getArgument(0));
+    createReturn(relu);
+    return relu;
+  }
+
+  // Creates a func with a to_layout op followed by a chain of `numOps` relu
+  // ops on tensorType. Returns the relu ops in order.
+  //
+  llvm::SmallVector<mlir::Operation *>
+  createChain(mlir::RankedTensorType tensorType, int numOps) {
+    createFunc(tensorType);
+
+    mlir::Value value =
+        builder
+            .create<ToLayoutOp>(builder.getUnknownLoc(), tensorType,
+                                func.getArgument(0),
+                                createEmptyTensor(tensorType))
+            .getResult();
+
+    llvm::SmallVector<mlir::Operation *> ops;
+    for (int i = 0; i < numOps; i++) {
+      ops.push_back(createRelu(value));
+      value = ops.back()->getResult(0);
+    }
+
+    createReturn(ops.back());
+    return ops;
+  }
+
+  std::vector<LayoutAttr> getLegalLayouts(mlir::Operation *op,
+                                          LegalLayoutCache *cache = nullptr,
+                                          OpCostModel *costModel = nullptr) {
+    LegalGridAnalysis legalGridAnalysis(op);
+    legalGridAnalysis.init(LegalGridAnalysisInput(
+        systemDesc.getChipDescs()[0], device.getWorkerGrid(),
+        mlir::cast<mlir::RankedTensorType>(op->getResult(0).getType()),
+        nullptr, &layoutSizeCache, cache, costModel));
+    return legalGridAnalysis.getResult();
+  }
+};
+
+} // namespace mlir::tt::ttir
+
+#endif // TTMLIR_TEST_UNITTESTS_OPTIMIZER_OPTIMIZERTESTBASE_H
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "OptimizerTestBase.h"
+
+#include "ttmlir/Dialect/TTIR/Analysis/DPShardingPolicy.h"
+#include "ttmlir/Dialect/TTIR/Analysis/L1Usage.h"
+#include "ttmlir/Dialect/TTIR/Analysis/ShardSolver.h"
+
+using namespace mlir::tt;
+
+// Exposes layout picking of a single resolved chain.
+class TestDPShardingPolicy : public ttir::DPShardingPolicy {
+public:
+  using ttir::DPShardingPolicy::DPShardingPolicy;
+  using ttir::DPShardingPolicy::pickOpLayouts;
+};
+
+class DPShardingPolicyBase : public ttir::OptimizerTestBase {};
+
+// Last two ops of a chain are tuned to a layout which does not fit into L1
+// next to itself. The tuned pair is not legal, so the policy picks among all
+// layouts left by the solver instead of failing.
+TEST_F(DPShardingPolicyBase, ConflictingTunedLayouts) {
+  mlir::RankedTensorType tensorType = getTensorType(1024, 1024);
+  llvm::SmallVector<mlir::Operation *> ops = createChain(tensorType, 3);
+  LayoutAttr bigLayout = getShardedLayout(tensorType, 4, 4);
+  LayoutAttr smallLayout = getShardedLayout(tensorType, 8, 8);
+
+  auto getL1Usage = [&](LayoutAttr layout) {
+    return layoutSizeCache.getLayoutSizeBytes(device, tensorType.getShape(),
+                                              layout, MemorySpace::DeviceL1);
+  };
+  uint64_t bigExecUsage = ttir::getOpL1ExecUsage(ops.back(), bigLayout);
+  uint64_t smallExecUsage = ttir::getOpL1ExecUsage(ops.back(), smallLayout);
+
+  // Two big tensors never fit, a big and a small one always do.
+  unsigned usableL1CacheSize = 2 * getL1Usage(bigLayout) + bigExecUsage;
+  ASSERT_LT(getL1Usage(smallLayout) + smallExecUsage,
+            getL1Usage(bigLayout) + bigExecUsage);
+
+  llvm::DenseMap<mlir::Operation *, std::vector<LayoutAttr>> legalLayouts;
+  ttir::ShardChainConfig shardChainConfig;
+  for (mlir::Operation *op : ops) {
+    legalLayouts[op] = {bigLayout, smallLayout};
+    shardChainConfig.addShardSpec(ttir::ShardSpec{op, 1, LayoutAttr()});
+  }
+  shardChainConfig.build();
+
+  ttir::TuningDatabase tuningDatabase(
+      ttir::LegalLayoutCache::getFingerprint(systemDesc, device));
+  tuningDatabase.record(ops[1], bigLayout, 1.0);
+  tuningDatabase.record(ops[2], bigLayout, 1.0);
+
+  ttir::AnalyticalOpCostModel costModel(systemDesc.getChipDescs()[0], device,
+                                        &layoutSizeCache);
+  std::vector<ttir::ShardChainConfig> shardChainConfigs;
+  llvm::DenseMap<mlir::func::FuncOp, llvm::SmallVector<mlir::Operation *>>
+      schedule;
+  TestDPShardingPolicy policy(module.get(), shardChainConfigs, legalLayouts,
+                              schedule, usableL1CacheSize, &layoutSizeCache,
+                              &costModel, &tuningDatabase);
+
+  ttir::ShardSolver shardSolver = shardChainConfig.resolve(
+      legalLayouts, usableL1CacheSize, &layoutSizeCache);
+  for (mlir::Operation *op : {ops[1], ops[2]}) {
+    bool hasBigLayout = false;
+    for (LayoutAttr layout : shardSolver.at(op)) {
+      hasBigLayout |= layout == bigLayout;
+    }
+    ASSERT_TRUE(hasBigLayout);
+  }
+
+  policy.pickOpLayouts(shardChainConfig, shardSolver);
+  ttir::ShardSolverSolution solution = shardSolver.finish();
+  ASSERT_EQ(solution.selectedOpLayout.size(), ops.size());
+  EXPECT_FALSE(solution.selectedOpLayout.lookup(ops[1]) == bigLayout &&
+               solution.selectedOpLayout.lookup(ops[2]) == bigLayout);
+}
@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "OptimizerTestBase.h"
+
+#include "ttmlir/Dialect/TTIR/Analysis/L1SpillAnalysis.h"
+
+using namespace mlir::tt;
+
+class L1SpillAnalysisBase : public ttir::OptimizerTestBase {
+public:
+  ttir::L1SpillAnalysisResult
+  runAnalysis(const llvm::DenseMap<mlir::Operation *, LayoutAttr> &opLayouts,
+              unsigned usableL1CacheSize) {
+    ttir::L1SpillAnalysis analysis(module.get());
+    analysis.init(ttir::L1SpillAnalysisInput({}, opLayouts, usableL1CacheSize,
+                                             &layoutSizeCache, {}));
+    return analysis.getResult();
+  }
+};
+
+// Every tensor live at a step is either produced or used by its op, so there
+// is nothing to spill. Steps over usable L1 are reported instead of being
+// silently left over-subscribed.
+TEST_F(L1SpillAnalysisBase, ReportsOverSubscribedOps) {
+  mlir::RankedTensorType tensorType = getTensorType(256, 256);
+  createFunc(tensorType);
+  mlir::Operation *relu0 = createRelu(func.getArgument(0));
+  mlir::Operation *relu1 = createRelu(relu0->getResult(0));
+  createReturn(relu1);
+
+  llvm::DenseMap<mlir::Operation *, LayoutAttr> opLayouts;
+  opLayouts[relu0] = getShardedLayout(tensorType, 8, 8);
+  opLayouts[relu1] = getShardedLayout(tensorType, 8, 8);
+
+  ttir::L1SpillAnalysisResult result = runAnalysis(opLayouts, 1u << 30);
+  EXPECT_TRUE(result.spills.empty());
+  EXPECT_TRUE(result.overSubscribedOps.empty());
+
+  result = runAnalysis(opLayouts, 1);
+  EXPECT_TRUE(result.spills.empty());
+  EXPECT_EQ(result.overSubscribedOps,
+            llvm::SmallVector<mlir::Operation *>({relu0, relu1}));
+}
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "OptimizerTestBase.h"
+
+#include "ttmlir/Dialect/TTIR/Analysis/LayoutOverrideMatcher.h"
+
+using namespace mlir::tt;
+
+class LayoutOverrideMatcherBase : public ttir::OptimizerTestBase {
+public:
+  static LayoutOverrideParams getParams(int64_t grid) {
+    return LayoutOverrideParams{{grid, grid},
+                                MemorySpace::DeviceL1,
+                                TensorMemoryLayout::BlockSharded};
+  }
+};
+
+// Exact name override wins over op type overrides, which win over globs. Op
+// type override with shape wins over the one without.
+TEST_F(LayoutOverrideMatcherBase, Precedence) {
+  mlir::Operation *softmaxRelu = createRelu(256, 256);
+  softmaxRelu->setLoc(mlir::NameLoc::get(
+      builder.getStringAttr("layer0.attention.softmax")));
+  mlir::Operation *namedRelu = createRelu(256, 256);
+  namedRelu->setLoc(mlir::NameLoc::get(builder.getStringAttr("relu_0")));
+  mlir::Operation *otherRelu = createRelu(64, 256);
+
+  llvm::StringMap<LayoutOverrideParams> overrides;
+  overrides["relu_0"] = getParams(1);
+  overrides["*attention.softmax*"] = getParams(2);
+  overrides["@ttir.relu<256x*>"] = getParams(3);
+  overrides["@ttir.relu"] = getParams(4);
+
+  llvm::Expected<ttir::LayoutOverrideMatcher> matcher =
+      ttir::LayoutOverrideMatcher::create(overrides);
+  ASSERT_TRUE(static_cast<bool>(matcher));
+  EXPECT_EQ(matcher->lookup(namedRelu)->grid[0], 1);
+  EXPECT_EQ(matcher->lookup(softmaxRelu)->grid[0], 3);
+  EXPECT_EQ(matcher->lookup(otherRelu)->grid[0], 4);
+
+  overrides.erase("@ttir.relu<256x*>");
+  overrides.erase("@ttir.relu");
+  matcher = ttir::LayoutOverrideMatcher::create(overrides);
+  ASSERT_TRUE(static_cast<bool>(matcher));
+  EXPECT_EQ(matcher->lookup(softmaxRelu)->grid[0], 2);
+  EXPECT_EQ(matcher->lookup(otherRelu), nullptr);
+
+  EXPECT_FALSE(llvm::errorToBool(
+      ttir::LayoutOverrideMatcher::verifyKey("@ttir.relu<256x*>")));
+  EXPECT_TRUE(llvm::errorToBool(
+      ttir::LayoutOverrideMatcher::verifyKey("@ttir.relu<256xa>")));
+  EXPECT_TRUE(
+      llvm::errorToBool(ttir::LayoutOverrideMatcher::verifyKey("[a-")));
+}
+
+// Of several op type overrides with shape matching an op, the smallest key
+// wins regardless of the order keys were added in.
+TEST_F(LayoutOverrideMatcherBase, ShapedOverridesInKeyOrder) {
+  mlir::Operation *relu = createRelu(256, 256);
+
+  for (bool reversed : {false, true}) {
+    llvm::StringMap<LayoutOverrideParams> overrides;
+    if (reversed) {
+      overrides["@ttir.relu<256x*>"] = getParams(2);
+      overrides["@ttir.relu<*x256>"] = getParams(1);
+    } else {
+      overrides["@ttir.relu<*x256>"] = getParams(1);
+      overrides["@ttir.relu<256x*>"] = getParams(2);
+    }
+
+    llvm::Expected<ttir::LayoutOverrideMatcher> matcher =
+        ttir::LayoutOverrideMatcher::create(overrides);
+    ASSERT_TRUE(static_cast<bool>(matcher));
+    EXPECT_EQ(matcher->lookup(relu)->grid[0], 1);
+  }
+}
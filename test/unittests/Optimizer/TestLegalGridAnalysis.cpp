@@ -0,0 +1,182 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "OptimizerTestBase.h"
+
+using namespace mlir::tt;
+
+class LegalGridAnalysisBase : public ttir::OptimizerTestBase {};
+
+// Pruning keeps the cheapest and the smallest sharded layout of every memory
+// layout and drops layouts beaten by another one of the same memory layout in
+// both.
+TEST_F(LegalGridAnalysisBase, ParetoPruning) {
+  ttir::AnalyticalOpCostModel costModel(systemDesc.getChipDescs()[0], device,
+                                        &layoutSizeCache);
+  mlir::Operation *relu = createRelu(256, 256);
+  std::vector<LayoutAttr> allLayouts = getLegalLayouts(relu);
+  std::vector<LayoutAttr> prunedLayouts =
+      getLegalLayouts(relu, nullptr, &costModel);
+  EXPECT_LT(prunedLayouts.size(), allLayouts.size());
+
+  auto getL1Usage = [&](LayoutAttr layout) {
+    return layoutSizeCache.getLayoutSizeBytes(
+        device, {256, 256}, layout, layout.getMemorySpace());
+  };
+
+  for (TensorMemoryLayout memLayout :
+       {TensorMemoryLayout::BlockSharded, TensorMemoryLayout::HeightSharded,
+        TensorMemoryLayout::WidthSharded}) {
+    std::optional<LayoutAttr> cheapest;
+    std::optional<LayoutAttr> smallest;
+    for (LayoutAttr layout : allLayouts) {
+      if (layout.getMemLayout() != memLayout) {
+        continue;
+      }
+      if (!cheapest || costModel.getOpCost(relu, layout) <
+                           costModel.getOpCost(relu, *cheapest)) {
+        cheapest = layout;
+      }
+      if (!smallest || getL1Usage(layout) < getL1Usage(*smallest)) {
+        smallest = layout;
+      }
+    }
+
+    if (!cheapest) {
+      continue;
+    }
+
+    // Equal layouts may be swapped for one with the same cost and size.
+    auto containsEquivalent = [&](LayoutAttr expected) {
+      return llvm::any_of(prunedLayouts, [&](LayoutAttr layout) {
+        return layout.getMemLayout() == memLayout &&
+               costModel.getOpCost(relu, layout) <=
+                   costModel.getOpCost(relu, expected) &&
+               getL1Usage(layout) <= getL1Usage(expected);
+      });
+    };
+    EXPECT_TRUE(containsEquivalent(*cheapest));
+    EXPECT_TRUE(containsEquivalent(*smallest));
+  }
+
+  // No kept sharded layout is beaten by another kept one of the same memory
+  // layout.
+  for (LayoutAttr a : prunedLayouts) {
+    for (LayoutAttr b : prunedLayouts) {
+      if (a == b || a.getMemLayout() != b.getMemLayout() ||
+          !a.hasShardedL1TensorMemoryLayout()) {
+        continue;
+      }
+      double costA = costModel.getOpCost(relu, a);
+      double costB = costModel.getOpCost(relu, b);
+      bool dominates = costB <= costA && getL1Usage(b) <= getL1Usage(a) &&
+                       (costB < costA || getL1Usage(b) < getL1Usage(a));
+      EXPECT_FALSE(dominates);
+    }
+  }
+}
+
+// Tensor is 8x8 tiles. Block sharding on a single core is both slower and
+// larger per core than on the 8x8 grid, so it is dropped. Layouts of other
+// memory layouts do not prune it.
+TEST_F(LegalGridAnalysisBase, ParetoPruningDropsDominatedLayout) {
+  ttir::AnalyticalOpCostModel costModel(systemDesc.getChipDescs()[0], device,
+                                        &layoutSizeCache);
+  mlir::Operation *relu = createRelu(256, 256);
+  auto isBlockSharded = [](int64_t gridR, int64_t gridC) {
+    return [=](LayoutAttr layout) {
+      return layout.getMemLayout() == TensorMemoryLayout::BlockSharded &&
+             layout.getGrid().getShape()[0] == gridR &&
+             layout.getGrid().getShape()[1] == gridC;
+    };
+  };
+
+  std::vector<LayoutAttr> allLayouts = getLegalLayouts(relu);
+  auto singleCore = llvm::find_if(allLayouts, isBlockSharded(1, 1));
+  auto fullGrid = llvm::find_if(allLayouts, isBlockSharded(8, 8));
+  ASSERT_NE(singleCore, allLayouts.end());
+  ASSERT_NE(fullGrid, allLayouts.end());
+  ASSERT_LT(costModel.getOpCost(relu, *fullGrid),
+            costModel.getOpCost(relu, *singleCore));
+  ASSERT_LT(layoutSizeCache.getLayoutSizeBytes(device, {256, 256}, *fullGrid,
+                                               MemorySpace::DeviceL1),
+            layoutSizeCache.getLayoutSizeBytes(device, {256, 256},
+                                               *singleCore,
+                                               MemorySpace::DeviceL1));
+
+  std::vector<LayoutAttr> prunedLayouts =
+      getLegalLayouts(relu, nullptr, &costModel);
+  EXPECT_TRUE(llvm::none_of(prunedLayouts, isBlockSharded(1, 1)));
+
+  // Every memory layout keeps at least one sharded layout.
+  for (TensorMemoryLayout memLayout :
+       {TensorMemoryLayout::BlockSharded, TensorMemoryLayout::HeightSharded,
+        TensorMemoryLayout::WidthSharded}) {
+    EXPECT_TRUE(llvm::any_of(prunedLayouts, [&](LayoutAttr layout) {
+      return layout.getMemLayout() == memLayout;
+    }));
+  }
+}
+
+// Generated sharded grids leave no core without a shard, sharded layouts come
+// cheapest first.
+TEST_F(LegalGridAnalysisBase, ShardedGridsHaveNoEmptyCores) {
+  ttir::AnalyticalOpCostModel costModel(systemDesc.getChipDescs()[0], device,
+                                        &layoutSizeCache);
+  mlir::Operation *relu = createRelu(192, 160);
+  std::vector<LayoutAttr> legalLayouts =
+      getLegalLayouts(relu, nullptr, &costModel);
+
+  std::vector<LayoutAttr> shardedLayouts;
+  llvm::copy_if(legalLayouts, std::back_inserter(shardedLayouts),
+                [](LayoutAttr layout) {
+                  return layout.hasShardedL1TensorMemoryLayout();
+                });
+  ASSERT_FALSE(shardedLayouts.empty());
+
+  // Tensor is 6x5 tiles, last core along a dim may hold a partial shard but
+  // never none.
+  for (LayoutAttr layout : shardedLayouts) {
+    int64_t gridY = layout.getGrid().getShape()[0];
+    int64_t gridX = layout.getGrid().getShape()[1];
+    EXPECT_LT(llvm::divideCeil(6, gridY) * (gridY - 1), 6);
+    EXPECT_LT(llvm::divideCeil(5, gridX) * (gridX - 1), 5);
+  }
+
+  for (size_t i = 1; i < shardedLayouts.size(); ++i) {
+    EXPECT_LE(costModel.getOpCost(relu, shardedLayouts[i - 1]),
+              costModel.getOpCost(relu, shardedLayouts[i]));
+  }
+}
+
+TEST_F(LegalGridAnalysisBase, UnevenShardedGrid) {
+  // 7x9 tiles, only divisors 1 and 3 of 9 fit the 8x8 grid. With uneven
+  // shards 5 columns of cores are used, the last one holding a single tile.
+  mlir::Operation *relu = createRelu(224, 288);
+  std::vector<LayoutAttr> legalLayouts = getLegalLayouts(relu);
+
+  auto blockSharded = llvm::find_if(legalLayouts, [](LayoutAttr layout) {
+    return layout.getMemLayout() == TensorMemoryLayout::BlockSharded &&
+           layout.getGrid().getShape()[0] == 7 &&
+           layout.getGrid().getShape()[1] == 5;
+  });
+  ASSERT_NE(blockSharded, legalLayouts.end());
+
+  // Shards are 1x2 tiles, not 32x58 scalars which would split tiles across
+  // cores. Every core allocates a whole shard, the last column included.
+  EXPECT_EQ(blockSharded->getShardShape(),
+            llvm::SmallVector<int64_t>({32, 64}));
+  EXPECT_EQ(layoutSizeCache.getLayoutSizeBytes(device, {224, 288},
+                                               *blockSharded,
+                                               MemorySpace::DeviceL1),
+            32u * 64u * sizeof(float));
+
+  // Every sharded layout holds whole tiles on every core.
+  for (LayoutAttr layout : legalLayouts) {
+    if (layout.hasShardedL1TensorMemoryLayout()) {
+      EXPECT_EQ(layout.getShardShape()[0] % 32, 0);
+      EXPECT_EQ(layout.getShardShape()[1] % 32, 0);
+    }
+  }
+}
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "OptimizerTestBase.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+using namespace mlir::tt;
+
+class LegalLayoutCacheBase : public ttir::OptimizerTestBase {
+public:
+  ttir::LegalLayoutKey getKey(mlir::Operation *op) {
+    return ttir::LegalLayoutKey(
+        op->getName(),
+        mlir::cast<mlir::RankedTensorType>(op->getResult(0).getType()),
+        device.getWorkerGrid(), 64);
+  }
+};
+
+// Second of two identical ops reuses legal layouts of the first one, ops of
+// different shape do not.
+TEST_F(LegalLayoutCacheBase, IdenticalOpsShareLegalLayouts) {
+  ttir::LegalLayoutCache cache("");
+  mlir::Operation *relu = createRelu(256, 256);
+  mlir::Operation *identicalRelu = createRelu(256, 256);
+  mlir::Operation *otherRelu = createRelu(64, 256);
+
+  std::vector<LayoutAttr> legalLayouts = getLegalLayouts(relu, &cache);
+  EXPECT_EQ(getLegalLayouts(identicalRelu, &cache), legalLayouts);
+  EXPECT_EQ(getLegalLayouts(relu, nullptr), legalLayouts);
+  EXPECT_EQ(cache.getNumHits(), 1u);
+
+  getLegalLayouts(otherRelu, &cache);
+  EXPECT_EQ(cache.getNumHits(), 1u);
+  EXPECT_EQ(cache.getNumMisses(), 2u);
+}
+
+// Saved cache is loaded by cache with the same fingerprint only.
+TEST_F(LegalLayoutCacheBase, SaveAndLoad) {
+  llvm::SmallString<32> fingerprint =
+      ttir::LegalLayoutCache::getFingerprint(systemDesc, device);
+  ttir::LegalLayoutCache cache(fingerprint);
+  mlir::Operation *relu = createRelu(256, 256);
+  std::vector<LayoutAttr> legalLayouts = getLegalLayouts(relu, &cache);
+  ASSERT_FALSE(legalLayouts.empty());
+
+  llvm::SmallString<128> path;
+  ASSERT_FALSE(
+      llvm::sys::fs::createTemporaryFile("legal_layouts", "json", path));
+  ASSERT_TRUE(mlir::succeeded(cache.save(path)));
+
+  ttir::LegalLayoutCache loadedCache(fingerprint);
+  ASSERT_TRUE(mlir::succeeded(loadedCache.load(&context, path)));
+  const std::vector<LayoutAttr> *loadedLayouts =
+      loadedCache.lookup(getKey(relu));
+  ASSERT_NE(loadedLayouts, nullptr);
+  EXPECT_EQ(*loadedLayouts, legalLayouts);
+
+  ttir::LegalLayoutCache otherCache("other");
+  ASSERT_TRUE(mlir::succeeded(otherCache.load(&context, path)));
+  EXPECT_EQ(otherCache.lookup(getKey(relu)), nullptr);
+
+  llvm::sys::fs::remove(path);
+}
+
+// Entries are saved in the same order whatever order they were inserted in.
+TEST_F(LegalLayoutCacheBase, SaveIsSorted) {
+  mlir::Operation *relu = createRelu(256, 256);
+  mlir::Operation *otherRelu = createRelu(64, 256);
+  std::vector<LayoutAttr> layouts = getLegalLayouts(relu);
+  std::vector<LayoutAttr> otherLayouts = getLegalLayouts(otherRelu);
+
+  ttir::LegalLayoutCache cache("");
+  cache.insert(getKey(relu), layouts);
+  cache.insert(getKey(otherRelu), otherLayouts);
+  ttir::LegalLayoutCache reversedCache("");
+  reversedCache.insert(getKey(otherRelu), otherLayouts);
+  reversedCache.insert(getKey(relu), layouts);
+
+  llvm::SmallString<128> path;
+  llvm::SmallString<128> reversedPath;
+  ASSERT_FALSE(
+      llvm::sys::fs::createTemporaryFile("legal_layouts", "json", path));
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("legal_layouts", "json",
+                                                  reversedPath));
+  ASSERT_TRUE(mlir::succeeded(cache.save(path)));
+  ASSERT_TRUE(mlir::succeeded(reversedCache.save(reversedPath)));
+
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  auto reversedBuffer = llvm::MemoryBuffer::getFile(reversedPath);
+  ASSERT_TRUE(buffer && reversedBuffer);
+  EXPECT_EQ((*buffer)->getBuffer(), (*reversedBuffer)->getBuffer());
+
+  llvm::sys::fs::remove(path);
+  llvm::sys::fs::remove(reversedPath);
+}
+
+// File with a broken entry fails to load and adds none of its entries, not
+// even the valid ones before it.
+TEST_F(LegalLayoutCacheBase, BrokenFileLoadsNothing) {
+  llvm::SmallString<32> fingerprint =
+      ttir::LegalLayoutCache::getFingerprint(systemDesc, device);
+  ttir::LegalLayoutCache cache(fingerprint);
+  mlir::Operation *relu = createRelu(256, 256);
+  getLegalLayouts(relu, &cache);
+
+  llvm::SmallString<128> path;
+  ASSERT_FALSE(
+      llvm::sys::fs::createTemporaryFile("legal_layouts", "json", path));
+  ASSERT_TRUE(mlir::succeeded(cache.save(path)));
+
+  // Append an entry with a layout which does not parse.
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  ASSERT_TRUE(buffer);
+  llvm::Expected<llvm::json::Value> json =
+      llvm::json::parse((*buffer)->getBuffer());
+  ASSERT_TRUE(bool(json));
+  json->getAsObject()->getArray("entries")->push_back(llvm::json::Object{
+      {"op", "ttir.relu"},
+      {"type", "tensor<64x64xf32>"},
+      {"max_grid", llvm::json::Array({8, 8})},
+      {"max_sharded_grids", 64},
+      {"layouts", llvm::json::Array({"#tt.not_a_layout"})},
+  });
+  {
+    std::error_code ec;
+    llvm::raw_fd_ostream os(path, ec);
+    ASSERT_FALSE(ec);
+    os << *json;
+  }
+
+  ttir::LegalLayoutCache loadedCache(fingerprint);
+  EXPECT_TRUE(mlir::failed(loadedCache.load(&context, path)));
+  EXPECT_EQ(loadedCache.lookup(getKey(relu)), nullptr);
+
+  llvm::sys::fs::remove(path);
+}
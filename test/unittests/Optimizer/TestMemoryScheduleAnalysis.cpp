@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "OptimizerTestBase.h"
+
+#include "ttmlir/Dialect/TTIR/Analysis/MemoryScheduleAnalysis.h"
+
+using namespace mlir::tt;
+
+class MemoryScheduleAnalysisBase : public ttir::OptimizerTestBase {
+public:
+  mlir::RankedTensorType tensorType;
+
+  void SetUp() override {
+    ttir::OptimizerTestBase::SetUp();
+    tensorType = getTensorType(256, 256);
+    createFunc(tensorType);
+  }
+
+  LayoutAttr getLayout(MemorySpace memorySpace) {
+    return LayoutAttr::get(&context, tensorType, memorySpace,
+                           GridAttr::get(&context, 2));
+  }
+
+  mlir::Value getInput() { return func.getArgument(0); }
+
+  ttir::MemoryScheduleAnalysisResult
+  runAnalysis(const llvm::SmallVector<mlir::Operation *> &inputSchedule,
+              const llvm::DenseMap<mlir::Operation *, LayoutAttr> &opLayouts) {
+    llvm::DenseMap<mlir::func::FuncOp, llvm::SmallVector<mlir::Operation *>>
+        schedule;
+    if (!inputSchedule.empty()) {
+      schedule[func] = inputSchedule;
+    }
+
+    ttir::MemoryScheduleAnalysis analysis(module.get());
+    analysis.init(ttir::MemoryScheduleAnalysisInput(
+        schedule, opLayouts, 1024 * 1024 * 1024, &layoutSizeCache));
+    return analysis.getResult();
+  }
+};
+
+// Two branches, each a large L1 tensor reduced by an op with DRAM output. In
+// program order both large tensors are live at once, the memory aware
+// schedule finishes the first branch before starting the second one.
+TEST_F(MemoryScheduleAnalysisBase, ReorderLowersPeak) {
+  mlir::Operation *large0 = createRelu(getInput());
+  mlir::Operation *large1 = createRelu(getInput());
+  mlir::Operation *reduce0 = createRelu(large0->getResult(0));
+  mlir::Operation *reduce1 = createRelu(large1->getResult(0));
+  mlir::Operation *join =
+      createAdd(reduce0->getResult(0), reduce1->getResult(0));
+  createReturn(join);
+
+  llvm::DenseMap<mlir::Operation *, LayoutAttr> opLayouts;
+  opLayouts[large0] = getLayout(MemorySpace::DeviceL1);
+  opLayouts[large1] = getLayout(MemorySpace::DeviceL1);
+
+  ttir::MemoryScheduleAnalysisResult result = runAnalysis({}, opLayouts);
+  llvm::SmallVector<mlir::Operation *> expectedSchedule = {
+      large0, reduce0, large1, reduce1, join};
+  EXPECT_EQ(result.schedule.lookup(func), expectedSchedule);
+  EXPECT_GT(result.peakL1UsageBefore, 0u);
+  EXPECT_EQ(result.peakL1UsageAfter * 2, result.peakL1UsageBefore);
+}
+
+// Input schedule already finishes one branch before the other, in a different
+// order than the memory aware schedule would. Peak is not lowered, so input
+// schedule is kept.
+TEST_F(MemoryScheduleAnalysisBase, KeepInputScheduleIfNotWorse) {
+  mlir::Operation *large0 = createRelu(getInput());
+  mlir::Operation *large1 = createRelu(getInput());
+  mlir::Operation *reduce0 = createRelu(large0->getResult(0));
+  mlir::Operation *reduce1 = createRelu(large1->getResult(0));
+  mlir::Operation *join =
+      createAdd(reduce0->getResult(0), reduce1->getResult(0));
+  createReturn(join);
+
+  llvm::DenseMap<mlir::Operation *, LayoutAttr> opLayouts;
+  opLayouts[large0] = getLayout(MemorySpace::DeviceL1);
+  opLayouts[large1] = getLayout(MemorySpace::DeviceL1);
+
+  llvm::SmallVector<mlir::Operation *> inputSchedule = {
+      large1, reduce1, large0, reduce0, join};
+  ttir::MemoryScheduleAnalysisResult result =
+      runAnalysis(inputSchedule, opLayouts);
+  EXPECT_EQ(result.schedule.lookup(func), inputSchedule);
+  EXPECT_GT(result.peakL1UsageBefore, 0u);
+  EXPECT_EQ(result.peakL1UsageAfter, result.peakL1UsageBefore);
+}
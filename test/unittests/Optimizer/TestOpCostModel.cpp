@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "OptimizerTestBase.h"
+
+using namespace mlir::tt;
+
+class OpCostModelBase : public ttir::OptimizerTestBase {};
+
+// Small tensors do not have enough tiles to amortize launching all cores.
+TEST_F(OpCostModelBase, SmallTensorPrefersSmallerGrid) {
+  mlir::Operation *relu = createRelu(64, 64);
+  mlir::RankedTensorType tensorType =
+      mlir::cast<mlir::RankedTensorType>(relu->getResult(0).getType());
+  ttir::AnalyticalOpCostModel costModel(systemDesc.getChipDescs()[0], device,
+                                        &layoutSizeCache);
+
+  EXPECT_LT(costModel.getOpCost(relu, getShardedLayout(tensorType, 2, 2)),
+            costModel.getOpCost(relu, getShardedLayout(tensorType, 8, 8)));
+}
+
+// Large tensors are compute bound and benefit from the full grid.
+TEST_F(OpCostModelBase, LargeTensorPrefersFullGrid) {
+  mlir::Operation *relu = createRelu(1024, 1024);
+  mlir::RankedTensorType tensorType =
+      mlir::cast<mlir::RankedTensorType>(relu->getResult(0).getType());
+  ttir::AnalyticalOpCostModel costModel(systemDesc.getChipDescs()[0], device,
+                                        &layoutSizeCache);
+
+  EXPECT_LT(costModel.getOpCost(relu, getShardedLayout(tensorType, 8, 8)),
+            costModel.getOpCost(relu, getShardedLayout(tensorType, 4, 4)));
+}
+
+TEST_F(OpCostModelBase, ReshardCost) {
+  mlir::RankedTensorType tensorType = getTensorType(256, 256);
+  ttir::AnalyticalOpCostModel costModel(systemDesc.getChipDescs()[0], device,
+                                        &layoutSizeCache);
+  LayoutAttr dram = mlir::cast<LayoutAttr>(tensorType.getEncoding());
+  LayoutAttr sharded = getShardedLayout(tensorType, 4, 4);
+
+  EXPECT_EQ(costModel.getReshardCost(tensorType, sharded, sharded), 0);
+  EXPECT_GT(costModel.getReshardCost(tensorType, dram, sharded), 0);
+}
@@ -0,0 +1,276 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "OptimizerTestBase.h"
+
+#include <chrono>
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "ttmlir/Dialect/TTIR/Analysis/L1Usage.h"
+#include "ttmlir/Dialect/TTIR/Analysis/ShardChainConfig.h"
+#include "ttmlir/Dialect/TTIR/Analysis/ShardSolver.h"
+#include "ttmlir/Dialect/TTIR/Analysis/TensorSplit.h"
+
+using namespace mlir::tt;
+
+constexpr int64_t TensorDimX = 1024;
+constexpr int64_t TensorDimY = 1024;
+
+class ShardSolverBase : public ttir::OptimizerTestBase {
+public:
+  using ttir::OptimizerTestBase::getTensorType;
+
+  mlir::RankedTensorType getTensorType() {
+    return getTensorType(TensorDimX, TensorDimY);
+  }
+
+  llvm::SmallVector<mlir::Operation *> createChain(int numOps) {
+    return OptimizerTestBase::createChain(getTensorType(), numOps);
+  }
+
+  // Block sharded L1 layout on a gridR x gridC grid.
+  //
+  LayoutAttr createShardedLayout(int64_t gridR, int64_t gridC) {
+    return getShardedLayout(getTensorType(), gridR, gridC);
+  }
+
+  // Block sharded L1 layouts for every grid up to gridR x gridC, ordered by
+  // increasing grid size.
+  //
+  std::vector<LayoutAttr> createShardedLayouts(int64_t gridR, int64_t gridC) {
+    std::vector<LayoutAttr> layouts;
+    for (int64_t r = 1; r <= gridR; ++r) {
+      for (int64_t c = 1; c <= gridC; ++c) {
+        layouts.push_back(createShardedLayout(r, c));
+      }
+    }
+    return layouts;
+  }
+};
+
+// With 256 legal layouts per op, make only the last one (smallest shard) fit
+// into L1. The solver must be able to pick it.
+TEST_F(ShardSolverBase, LayoutsBeyond64AreUsable) {
+  llvm::SmallVector<mlir::Operation *> ops = createChain(2);
+  std::vector<LayoutAttr> layouts = createShardedLayouts(16, 16);
+  ASSERT_EQ(layouts.size(), 256u);
+
+  DeviceAttr device = getCurrentScopeDevice(ops.front());
+  llvm::SmallVector<uint64_t> sizes;
+  for (LayoutAttr layout : layouts) {
+    sizes.push_back(device.getLayoutSizeBytes(getTensorType().getShape(),
+                                              layout, MemorySpace::DeviceL1));
+  }
+  uint64_t minSize = *std::min_element(sizes.begin(), sizes.end());
+  ASSERT_EQ(minSize, sizes.back());
+
+  // Two tensors of the smallest shard size fit next to consumer's circular
+  // buffers and program, any other pair does not.
+  unsigned usableL1CacheSize =
+      2 * minSize + ttir::getOpL1ExecUsage(ops.back(), layouts.back()) + 1;
+
+  llvm::DenseMap<mlir::Operation *, std::vector<LayoutAttr>> legalLayouts;
+  std::vector<ttir::ShardSpec> shardSpecs;
+  llvm::DenseSet<mlir::Operation *> shardedOps;
+  for (mlir::Operation *op : ops) {
+    legalLayouts[op] = layouts;
+    shardSpecs.push_back(ttir::ShardSpec{op, 1, LayoutAttr()});
+    shardedOps.insert(op);
+  }
+
+  ttir::ShardSolver shardSolver(legalLayouts, shardSpecs, shardedOps,
+                                usableL1CacheSize, &layoutSizeCache);
+  for (mlir::Operation *op : ops) {
+    auto validLayouts = shardSolver.at(op);
+    ASSERT_EQ(validLayouts.size(), 1u);
+    EXPECT_TRUE(*validLayouts.begin() == layouts.back());
+    shardSolver.set(op, *validLayouts.begin());
+  }
+
+  // Only the chain input edge should be resharded.
+  ttir::ShardSolverSolution solution = shardSolver.finish();
+  EXPECT_EQ(solution.reshardedEdges.size(), 1u);
+}
+
+// No layout of the first op fits into L1 next to its input. Solver reports
+// the chain as unresolved instead of asserting, and the chain is marked
+// failed so its ops keep their default layouts.
+TEST_F(ShardSolverBase, FirstOpDoesNotFit) {
+  llvm::SmallVector<mlir::Operation *> ops = createChain(2);
+  std::vector<LayoutAttr> layouts = {createShardedLayout(1, 1)};
+  constexpr unsigned kUsableL1CacheSize = 1u << 20;
+  ASSERT_GT(layoutSizeCache.getLayoutSizeBytes(
+                getCurrentScopeDevice(ops.front()),
+                getTensorType().getShape(), layouts.front(),
+                MemorySpace::DeviceL1),
+            kUsableL1CacheSize);
+
+  llvm::DenseMap<mlir::Operation *, std::vector<LayoutAttr>> legalLayouts;
+  std::vector<ttir::ShardSpec> shardSpecs;
+  llvm::DenseSet<mlir::Operation *> shardedOps;
+  ttir::ShardChainConfig shardChainConfig;
+  for (mlir::Operation *op : ops) {
+    legalLayouts[op] = layouts;
+    shardSpecs.push_back(ttir::ShardSpec{op, 1, LayoutAttr()});
+    shardedOps.insert(op);
+    shardChainConfig.addShardSpec(ttir::ShardSpec{op, 1, LayoutAttr()});
+  }
+
+  ttir::ShardSolver shardSolver(legalLayouts, shardSpecs, shardedOps,
+                                kUsableL1CacheSize, &layoutSizeCache);
+  EXPECT_FALSE(shardSolver.isResolved());
+
+  shardChainConfig.build();
+  shardChainConfig.resolve(legalLayouts, kUsableL1CacheSize,
+                           &layoutSizeCache);
+  EXPECT_EQ(shardChainConfig.getState(), ttir::ShardChainState::Failed);
+}
+
+// Repeated footprint queries are served from the cache and match the values
+// computed by the device.
+TEST_F(ShardSolverBase, LayoutSizeCacheHits) {
+  llvm::SmallVector<mlir::Operation *> ops = createChain(4);
+  std::vector<LayoutAttr> layouts = createShardedLayouts(4, 4);
+
+  llvm::DenseMap<mlir::Operation *, std::vector<LayoutAttr>> legalLayouts;
+  std::vector<ttir::ShardSpec> shardSpecs;
+  llvm::DenseSet<mlir::Operation *> shardedOps;
+  for (mlir::Operation *op : ops) {
+    legalLayouts[op] = layouts;
+    shardSpecs.push_back(ttir::ShardSpec{op, 1, LayoutAttr()});
+    shardedOps.insert(op);
+  }
+
+  ttir::ShardSolver shardSolver(legalLayouts, shardSpecs, shardedOps,
+                                1u << 31, &layoutSizeCache);
+
+  // All ops share the output shape, so every layout is computed once.
+  //
+  EXPECT_EQ(layoutSizeCache.getNumMisses(), layouts.size());
+  EXPECT_GT(layoutSizeCache.getNumHits(), layoutSizeCache.getNumMisses());
+
+  DeviceAttr device = getCurrentScopeDevice(ops.front());
+  for (LayoutAttr layout : layouts) {
+    EXPECT_EQ(layoutSizeCache.getLayoutSizeBytes(
+                  device, getTensorType().getShape(), layout,
+                  MemorySpace::DeviceL1),
+              device.getLayoutSizeBytes(getTensorType().getShape(), layout,
+                                        MemorySpace::DeviceL1));
+  }
+}
+
+// Benchmark solve time with growing number of legal layouts per op. All
+// layout pairs fit into L1, so every edge is fully connected.
+TEST_F(ShardSolverBase, SolveTimeScaling) {
+  constexpr int kChainLength = 2;
+  constexpr unsigned kUsableL1CacheSize = 1u << 31;
+  llvm::SmallVector<mlir::Operation *> ops = createChain(kChainLength);
+
+  for (int64_t gridDim : {8, 16, 32}) {
+    std::vector<LayoutAttr> layouts = createShardedLayouts(gridDim, gridDim);
+
+    llvm::DenseMap<mlir::Operation *, std::vector<LayoutAttr>> legalLayouts;
+    std::vector<ttir::ShardSpec> shardSpecs;
+    llvm::DenseSet<mlir::Operation *> shardedOps;
+    for (mlir::Operation *op : ops) {
+      legalLayouts[op] = layouts;
+      shardSpecs.push_back(ttir::ShardSpec{op, 1, LayoutAttr()});
+      shardedOps.insert(op);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ttir::ShardSolver shardSolver(legalLayouts, shardSpecs, shardedOps,
+                                  kUsableL1CacheSize, &layoutSizeCache);
+    for (mlir::Operation *op : ops) {
+      auto validLayouts = shardSolver.at(op);
+      ASSERT_EQ(validLayouts.size(), layouts.size());
+      shardSolver.set(op, *validLayouts.begin());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(shardSolver.finish().selectedOpLayout.size(), ops.size());
+    llvm::outs()
+        << "ShardSolver: " << layouts.size() << " layouts/op, "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+               .count()
+        << " us\n";
+  }
+}
+
+// Benchmark solve time on chains of growing length. Every tenth op only has a
+// layout which does not fit into L1 together with any layout of its
+// neighbours, so both of its edges have to be resharded.
+TEST_F(ShardSolverBase, ChainLengthScaling) {
+  constexpr unsigned kUsableL1CacheSize = 1u << 20;
+  std::vector<LayoutAttr> smallLayouts = {
+      createShardedLayout(8, 8), createShardedLayout(8, 4),
+      createShardedLayout(4, 8), createShardedLayout(4, 4)};
+  std::vector<LayoutAttr> bigLayouts = {createShardedLayout(1, 1)};
+
+  for (int chainLength : {10, 100, 1000, 10000}) {
+    llvm::SmallVector<mlir::Operation *> ops = createChain(chainLength);
+
+    llvm::DenseMap<mlir::Operation *, std::vector<LayoutAttr>> legalLayouts;
+    std::vector<ttir::ShardSpec> shardSpecs;
+    llvm::DenseSet<mlir::Operation *> shardedOps;
+    for (int i = 0; i < chainLength; i++) {
+      mlir::Operation *op = ops[i];
+      legalLayouts[op] = (i % 10 == 5) ? bigLayouts : smallLayouts;
+      shardSpecs.push_back(ttir::ShardSpec{op, 1, LayoutAttr()});
+      shardedOps.insert(op);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ttir::ShardSolver shardSolver(legalLayouts, shardSpecs, shardedOps,
+                                  kUsableL1CacheSize, &layoutSizeCache);
+    for (mlir::Operation *op : ops) {
+      shardSolver.set(op, *shardSolver.at(op).begin());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // Chain input edge plus both edges of every big op.
+    //
+    ttir::ShardSolverSolution solution = shardSolver.finish();
+    EXPECT_EQ(solution.reshardedEdges.size(),
+              1u + 2u * static_cast<size_t>(chainLength / 10));
+    llvm::outs()
+        << "ShardSolver: " << chainLength << " ops, "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+               .count()
+        << " us\n";
+  }
+}
+
+// Chain of relus splits along the outer dim into slices of whole tile rows,
+// and slice layout keeps the grid with a smaller shard.
+//
+TEST_F(ShardSolverBase, TensorSplitChain) {
+  llvm::SmallVector<mlir::Operation *> ops = createChain(2);
+  mlir::RankedTensorType tensorType = getTensorType();
+  LayoutAttr layout = createShardedLayout(8, 8);
+
+  for (mlir::Operation *op : ops) {
+    EXPECT_TRUE(ttir::canSplitAlongOuterDim(op));
+    EXPECT_TRUE(ttir::isSplitOperand(op, 0));
+    EXPECT_FALSE(ttir::isSplitOperand(op, 1));
+  }
+
+  EXPECT_TRUE(ttir::isValidSplitFactor(tensorType, layout, 1));
+  EXPECT_TRUE(ttir::isValidSplitFactor(tensorType, layout, 16));
+  EXPECT_FALSE(ttir::isValidSplitFactor(tensorType, layout, 3));
+  EXPECT_FALSE(ttir::isValidSplitFactor(tensorType, layout, 64));
+
+  EXPECT_EQ(ttir::getSplitShape(tensorType.getShape(), 4),
+            llvm::SmallVector<int64_t>({TensorDimX / 4, TensorDimY}));
+  LayoutAttr splitLayout =
+      ttir::getSplitLayout(&context, tensorType.getShape(), layout, 4);
+  EXPECT_EQ(splitLayout.getGrid(), layout.getGrid());
+  EXPECT_EQ(splitLayout.getShardShape()[0] * 4, layout.getShardShape()[0]);
+  EXPECT_EQ(ttir::getSplitLayout(&context, tensorType.getShape(), layout, 1),
+            layout);
+}
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: (c) 2024 Tenstorrent AI ULC
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "OptimizerTestBase.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "ttmlir/Dialect/TTIR/Analysis/TuningDatabase.h"
+#include "ttmlir/Target/Common/tuning_db_generated.h"
+
+using namespace mlir::tt;
+
+class TuningDatabaseBase : public ttir::OptimizerTestBase {
+public:
+  llvm::SmallString<32> fingerprint;
+
+  void SetUp() override {
+    ttir::OptimizerTestBase::SetUp();
+    fingerprint = ttir::LegalLayoutCache::getFingerprint(systemDesc, device);
+  }
+};
+
+// Exported tuning database is imported by database with the same fingerprint
+// only. Estimates don't override measured latency of the same layout.
+TEST_F(TuningDatabaseBase, ExportAndImport) {
+  mlir::Operation *relu = createRelu(256, 256);
+  mlir::Operation *otherRelu = createRelu(64, 256);
+  std::vector<LayoutAttr> legalLayouts = getLegalLayouts(relu);
+  ASSERT_GE(legalLayouts.size(), 2u);
+
+  ttir::TuningDatabase database(fingerprint);
+  database.record(relu, legalLayouts[1], 10.0, /*measured=*/true);
+  database.record(relu, legalLayouts[1], 20.0);
+  EXPECT_EQ(database.lookup(relu)->latency, 10.0);
+  EXPECT_FALSE(database.lookup(otherRelu).has_value());
+
+  llvm::SmallString<128> path;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("tuning", "ttdb", path));
+  ASSERT_TRUE(mlir::succeeded(database.exportTo(path)));
+
+  ttir::TuningDatabase importedDatabase(fingerprint);
+  ASSERT_TRUE(
+      mlir::succeeded(importedDatabase.import(builder.getUnknownLoc(), path)));
+  std::optional<ttir::TuningRecord> tuned = importedDatabase.lookup(relu);
+  ASSERT_TRUE(tuned.has_value());
+  EXPECT_EQ(tuned->layout, legalLayouts[1]);
+  EXPECT_EQ(tuned->latency, 10.0);
+  EXPECT_TRUE(tuned->measured);
+
+  importedDatabase.record(relu, legalLayouts[0], 5.0);
+  EXPECT_EQ(importedDatabase.lookup(relu)->layout, legalLayouts[0]);
+  EXPECT_EQ(importedDatabase.lookupImported(relu)->layout, legalLayouts[1]);
+  EXPECT_EQ(importedDatabase.size(), 1u);
+
+  ttir::TuningDatabase otherDatabase("other");
+  ASSERT_TRUE(
+      mlir::succeeded(otherDatabase.import(builder.getUnknownLoc(), path)));
+  EXPECT_FALSE(otherDatabase.lookup(relu).has_value());
+
+  llvm::sys::fs::remove(path);
+}
+
+// Import of a file with a record missing its layout fails and keeps records
+// of the earlier import usable.
+TEST_F(TuningDatabaseBase, FailedImportKeepsRecords) {
+  mlir::Operation *relu = createRelu(256, 256);
+  std::vector<LayoutAttr> legalLayouts = getLegalLayouts(relu);
+  ASSERT_FALSE(legalLayouts.empty());
+
+  ttir::TuningDatabase database(fingerprint);
+  database.record(relu, legalLayouts[0], 10.0);
+  llvm::SmallString<128> path;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("tuning", "ttdb", path));
+  ASSERT_TRUE(mlir::succeeded(database.exportTo(path)));
+
+  ttir::TuningDatabase importedDatabase(fingerprint);
+  ASSERT_TRUE(
+      mlir::succeeded(importedDatabase.import(builder.getUnknownLoc(), path)));
+
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<::tt::target::TuningRecord>> records = {
+      ::tt::target::CreateTuningRecordDirect(
+          fbb, ttir::TuningDatabase::getOpSignature(relu).c_str(),
+          /*layout=*/nullptr, 1.0, false)};
+  ::tt::target::FinishSizePrefixedTuningDatabaseBuffer(
+      fbb, ::tt::target::CreateTuningDatabaseDirect(
+               fbb, ttir::TuningDatabase::kFormatVersion, fingerprint.c_str(),
+               &records));
+
+  llvm::SmallString<128> invalidPath;
+  ASSERT_FALSE(
+      llvm::sys::fs::createTemporaryFile("tuning", "ttdb", invalidPath));
+  {
+    std::error_code error;
+    llvm::raw_fd_ostream os(invalidPath, error);
+    ASSERT_FALSE(error);
+    os.write(reinterpret_cast<const char *>(fbb.GetBufferPointer()),
+             fbb.GetSize());
+  }
+
+  EXPECT_TRUE(mlir::failed(
+      importedDatabase.import(builder.getUnknownLoc(), invalidPath)));
+  std::optional<ttir::TuningRecord> tuned = importedDatabase.lookup(relu);
+  ASSERT_TRUE(tuned.has_value());
+  EXPECT_EQ(tuned->layout, legalLayouts[0]);
+  EXPECT_EQ(tuned->latency, 10.0);
+
+  llvm::sys::fs::remove(path);
+  llvm::sys::fs::remove(invalidPath);
+}
+
+// Record with a layout which no longer parses is reported and skipped on
+// import, other records of the file are still imported.
+TEST_F(TuningDatabaseBase, InvalidLayoutSkippedOnImport) {
+  mlir::Operation *relu = createRelu(256, 256);
+  mlir::Operation *otherRelu = createRelu(64, 256);
+  std::vector<LayoutAttr> legalLayouts = getLegalLayouts(relu);
+  ASSERT_FALSE(legalLayouts.empty());
+
+  flatbuffers::FlatBufferBuilder fbb;
+  std::string layout;
+  llvm::raw_string_ostream os(layout);
+  legalLayouts[0].print(os);
+  std::vector<flatbuffers::Offset<::tt::target::TuningRecord>> records = {
+      ::tt::target::CreateTuningRecordDirect(
+          fbb, ttir::TuningDatabase::getOpSignature(relu).c_str(),
+          os.str().c_str(), 1.0, false),
+      ::tt::target::CreateTuningRecordDirect(
+          fbb, ttir::TuningDatabase::getOpSignature(otherRelu).c_str(),
+          "#tt.not_a_layout", 2.0, false)};
+  ::tt::target::FinishSizePrefixedTuningDatabaseBuffer(
+      fbb, ::tt::target::CreateTuningDatabaseDirect(
+               fbb, ttir::TuningDatabase::kFormatVersion, fingerprint.c_str(),
+               &records));
+
+  llvm::SmallString<128> path;
+  ASSERT_FALSE(llvm::sys::fs::createTemporaryFile("tuning", "ttdb", path));
+  {
+    std::error_code error;
+    llvm::raw_fd_ostream fileOs(path, error);
+    ASSERT_FALSE(error);
+    fileOs.write(reinterpret_cast<const char *>(fbb.GetBufferPointer()),
+                 fbb.GetSize());
+  }
+
+  std::vector<std::string> warnings;
+  mlir::ScopedDiagnosticHandler handler(
+      &context, [&](mlir::Diagnostic &diagnostic) {
+        EXPECT_EQ(diagnostic.getSeverity(), mlir::DiagnosticSeverity::Warning);
+        warnings.push_back(diagnostic.str());
+        return mlir::success();
+      });
+
+  ttir::TuningDatabase database(fingerprint);
+  ASSERT_TRUE(mlir::succeeded(database.import(builder.getUnknownLoc(), path)));
+  ASSERT_EQ(warnings.size(), 1u);
+  EXPECT_NE(warnings[0].find("#tt.not_a_layout"), std::string::npos);
+
+  std::optional<ttir::TuningRecord> tuned = database.lookupImported(relu);
+  ASSERT_TRUE(tuned.has_value());
+  EXPECT_EQ(tuned->layout, legalLayouts[0]);
+  EXPECT_FALSE(database.lookupImported(otherRelu).has_value());
+  EXPECT_EQ(database.size(), 1u);
+
+  llvm::sys::fs::remove(path);
+}
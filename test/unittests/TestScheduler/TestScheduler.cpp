@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include <random>
 
@@ -12,6 +13,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
@@ -249,3 +251,119 @@ TEST_F(SchedulerBase, VerifyFork) {
   scheduler.scheduleOp(scheduleableOps[0]);
   ASSERT_FALSE(scheduler.hasUnscheduledOps());
 }
+
+// Test the priority hook on a fork where the second branch is longer than the
+// first one. Critical path priority should pick the longer branch first even
+// though the shorter one comes first in program order.
+TEST_F(SchedulerBase, CriticalPathPriority) {
+  mlir::Value dest = createEmptyTensor();
+  mlir::Value lhs = func.getBody().getBlocks().front().getArgument(0);
+  mlir::Value rhs = func.getBody().getBlocks().front().getArgument(1);
+  mlir::ArrayAttr attrs = builder.getArrayAttr(createOperandConstraints());
+  ttir::TTIROp root = builder.create<ttir::AddOp>(builder.getUnknownLoc(), lhs,
+                                                  rhs, dest, attrs);
+  mlir::Value rootResult = root.getOperation()->getResult(0);
+
+  // Short branch, single op
+  dest = createEmptyTensor();
+  ttir::TTIROp shortOp = builder.create<ttir::AddOp>(
+      builder.getUnknownLoc(), lhs, rootResult, dest, attrs);
+
+  // Long branch, three ops
+  dest = createEmptyTensor();
+  ttir::TTIROp longOp = builder.create<ttir::AddOp>(
+      builder.getUnknownLoc(), lhs, rootResult, dest, attrs);
+  mlir::Value longResult = longOp.getOperation()->getResult(0);
+  for (int i = 0; i < 2; i++) {
+    dest = createEmptyTensor();
+    longResult =
+        builder
+            .create<ttir::AddOp>(builder.getUnknownLoc(), lhs, longResult, dest,
+                                 attrs)
+            .getOperation()
+            ->getResult(0);
+  }
+
+  mlir::tt::scheduler::Scheduler scheduler(&func);
+  EXPECT_EQ(scheduler.getCriticalPathLength(root.getOperation()), 4);
+  EXPECT_EQ(scheduler.getCriticalPathLength(shortOp.getOperation()), 1);
+  EXPECT_EQ(scheduler.getCriticalPathLength(longOp.getOperation()), 3);
+
+  EXPECT_EQ(scheduler.getNextCriticalPathOp(), root.getOperation());
+  scheduler.scheduleOp(
+      scheduler.getNextScheduleableOp(scheduler.criticalPathPriority()));
+  llvm::SmallVector<mlir::Operation *> scheduleableOps =
+      scheduler.getScheduleableOps();
+  ASSERT_EQ(scheduleableOps.size(), 2);
+
+  // Program order is kept by getScheduleableOps
+  EXPECT_EQ(scheduleableOps[0], shortOp.getOperation());
+  EXPECT_EQ(scheduler.getNextScheduleableOp(scheduler.criticalPathPriority()),
+            longOp.getOperation());
+  EXPECT_EQ(scheduler.getNextCriticalPathOp(), longOp.getOperation());
+
+  // Constant priority falls back to program order
+  EXPECT_EQ(scheduler.getNextScheduleableOp(
+                [](mlir::Operation *) -> int64_t { return 0; }),
+            shortOp.getOperation());
+
+  // Scheduled ops leave the queue, a snapshot keeps its own copy
+  scheduler.scheduleOp(longOp.getOperation());
+  mlir::Operation *longUser =
+      *longOp.getOperation()->getResult(0).getUsers().begin();
+  EXPECT_EQ(scheduler.getNextCriticalPathOp(), longUser);
+  std::unique_ptr<mlir::tt::scheduler::Scheduler> snapshot =
+      scheduler.snapshot();
+  scheduler.scheduleOp(longUser);
+  EXPECT_EQ(scheduler.getNextCriticalPathOp(), shortOp.getOperation());
+  EXPECT_EQ(snapshot->getNextCriticalPathOp(), longUser);
+}
+
+// Benchmark scheduling time on chains of growing length. Every op is queried
+// for schedulable ops twice, same as sharding policies do.
+TEST_F(SchedulerBase, ScheduleTimeScaling) {
+  mlir::ArrayAttr attrs = builder.getArrayAttr(createOperandConstraints());
+
+  for (int numberOfOps : {100, 1000, 10000, 20000}) {
+    builder.setInsertionPointToEnd(&module->getBodyRegion().front());
+    createFuncOp();
+
+    mlir::Value lhs = func.getBody().getBlocks().front().getArgument(0);
+    mlir::Value rhs = func.getBody().getBlocks().front().getArgument(1);
+    std::vector<mlir::Operation *> ops;
+    for (int i = 0; i < numberOfOps; i++) {
+      mlir::Value dest = createEmptyTensor();
+      mlir::Operation *op =
+          builder
+              .create<ttir::AddOp>(builder.getUnknownLoc(), lhs, rhs, dest,
+                                   attrs)
+              .getOperation();
+      lhs = rhs;
+      rhs = op->getResult(0);
+      ops.push_back(op);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    mlir::tt::scheduler::Scheduler scheduler(&func);
+    while (scheduler.hasUnscheduledOps()) {
+      llvm::SmallVector<mlir::Operation *> scheduleableOps =
+          scheduler.getScheduleableOps();
+      ASSERT_EQ(scheduleableOps.size(), 1);
+      scheduler.scheduleOp(scheduleableOps[0]);
+      scheduler.getScheduleableOps();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    llvm::SmallVector<mlir::Operation *> schedule = scheduler.getSchedule();
+    ASSERT_EQ(schedule.size(), ops.size());
+    for (std::size_t i = 0; i < ops.size(); i++) {
+      EXPECT_EQ(ops[i], schedule[i]);
+    }
+
+    llvm::outs()
+        << "Scheduler: " << numberOfOps << " ops, "
+        << std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+               .count()
+        << " us\n";
+  }
+}